@@ -1,14 +1,18 @@
 #pragma once
 
-#include <vector>
+#include <deque>
 #include <string>
-#include <algorithm>
+#include <unordered_map>
 #include "Admin.cpp"
 
 // Singleton Class for Admins
 class AdminManager {
 private:
-    vector<Admin> admins;
+    // deque keeps Admin* returned from login valid while admins are added
+    deque<Admin> admins;
+
+    // Secondary index: email -> slot in admins
+    unordered_map<string, size_t> emailIndex;
 
     // Private constructor
     AdminManager() = default;
@@ -25,35 +29,26 @@ public:
     }
 
     void addAdmin(const Admin &admin) {
+        emailIndex[admin.getEmail()] = admins.size();
         admins.push_back(admin);
     }
 
-    const vector<Admin> &getAdmins() const {
+    const deque<Admin> &getAdmins() const {
         return admins;
     }
 
-    Admin *getAdminByEmail(string email) {
-        auto it = find_if(admins.begin(), admins.end(),
-                        [email](Admin &admin) {
-                            return (admin.getEmail() == email);
-                        }
-        );
-
-        if (it != admins.end())
-            return &(*it);
+    Admin *getAdminByEmail(const string &email) {
+        auto it = emailIndex.find(email);
+        if (it != emailIndex.end())
+            return &admins[it->second];
 
         return nullptr;
     }
 
-    Admin *getAdminByEmailPass(string email, string password) {
-        auto it = find_if(admins.begin(), admins.end(),
-                        [email, password](Admin &admin) {
-                            return (admin.getEmail() == email && admin.getPassword() == password);
-                        }
-        );
-
-        if (it != admins.end())
-            return &(*it);
+    Admin *getAdminByEmailPass(const string &email, const string &password) {
+        Admin *admin = getAdminByEmail(email);
+        if (admin != nullptr && admin->getPassword() == password)
+            return admin;
 
         return nullptr;
     }
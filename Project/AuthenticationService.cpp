@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+
+#include "EventManager.cpp"
+#include "FanManager.cpp"
+#include "AdminManager.cpp"
+#include "StorageManager.cpp"
+
+using namespace std;
+
+enum class UserType {
+    Fan = 1,
+    Admin = 2,
+    NotAuth = 0
+};
+
+// DTO for Login Data
+struct LoginDTO {
+    string email;
+    string password;
+};
+
+class AuthenticationService {
+public:
+    // Logic uses FanManager and AdminManager to verify credentials
+    // Returns Pointer to the Fan/Admin or nullptr for wrong credentials
+    static User *login(const LoginDTO &user, UserType userType) {
+        if (userType == UserType::Fan) {
+            FanManager &fanManager = FanManager::getInstance();
+            return fanManager.getFanByEmailPass(user.email, user.password);
+        } else if (userType == UserType::Admin) {
+            AdminManager &adminManager = AdminManager::getInstance();
+            return adminManager.getAdminByEmailPass(user.email, user.password);
+        }
+        return nullptr;
+    }
+
+    // Only the Fan can register, Admin Added by developer
+    // Adds the fan and assigns its id, the caller logs it (StorageManager::logAddFan) once its locks are released
+    static bool _register(Fan &fan) {
+        FanManager &fanManager = FanManager::getInstance();
+
+        fan.setId(fanManager.getSize());
+        fanManager.addFan(fan);
+        return true;
+    }
+
+    static bool isExistingEmail(const string &email) {
+        FanManager &fanManager = FanManager::getInstance();
+        AdminManager &adminManager = AdminManager::getInstance();
+        return fanManager.getFanByEmail(email) != nullptr || adminManager.getAdminByEmail(email) != nullptr;
+    }
+};
@@ -0,0 +1,111 @@
+// Booking throughput with and without BookingShards
+// One hot event takes half of all bookings, the other half is spread over 10k cold events.
+// "direct" is the unsharded path: every caller looks the event up under one global lock and books
+// it from its own thread, so the hot event's counters bounce between all cores.
+// "sharded" submits to BookingShards, where each event is only booked by the core owning it, and waits
+// for each answer like TicketakService does; "async" keeps submitting without waiting, so the shards
+// drain their run queues in batches.
+//
+//   ticketak-booking-bench [--threads 1,2,4,8,16,32,64] [--bookings 200000] [--shards N]
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EventManager.cpp"
+#include "BookingShards.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// Runs total bookings split over nThreads, returns bookings/sec
+template <typename Book>
+static double measure(int nThreads, int total, int hotId, int nCold, Book book) {
+    atomic<long long> failed{0};
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t] {
+            mt19937 rng(t + 1);
+            int mine = total / nThreads + (t < total % nThreads ? 1 : 0);
+            for (int i = 0; i < mine; ++i) {
+                int eventId = (i & 1) ? hotId : hotId + 1 + (int)(rng() % nCold);
+                if (!book(eventId, t)) failed++;
+            }
+        });
+    }
+    for (thread& t : threads) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (failed) cout << "  (" << failed << " bookings failed)\n";
+    return total / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> steps;
+    stringstream list(argValue(argc, argv, "--threads", "1,2,4,8,16,32,64"));
+    for (string item; getline(list, item, ','); ) steps.push_back(stoi(item));
+    const int total = stoi(argValue(argc, argv, "--bookings", "200000"));
+    const unsigned nShards = stoul(argValue(argc, argv, "--shards", to_string(max(1u, thread::hardware_concurrency()))));
+    const int nCold = 10000;
+
+    EventManager& eventManager = EventManager::getInstance();
+    Event hot(0, "Final Match", Category::Sports, Date{1, 1, 2030},
+        TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 0},
+        TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 0},
+        TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), 50000000});
+    eventManager.addEvent(hot);
+    for (int i = 0; i < nCold; ++i) {
+        Event cold(0, "Event " + to_string(i), Category::Other, Date{1, 1, 2030},
+            TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 0},
+            TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 0},
+            TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), 5000});
+        eventManager.addEvent(cold);
+    }
+
+    mutex managersMutex;
+    auto resolve = [&](int eventId) {
+        lock_guard<mutex> lock(managersMutex);
+        return eventManager.getEvent(eventId);
+    };
+    BookingShards shards(resolve, nShards);
+    PrepaidPayment payment;
+    const TicketTypePrice regular{TicketType::Regular, Money::pounds(100)};
+
+    cout << total << " bookings per step, 1 hot + " << nCold << " cold events, " << shards.size() << " shards\n";
+    cout << "threads   direct bookings/sec   sharded bookings/sec   async bookings/sec\n";
+    for (int nThreads : steps) {
+        double direct = measure(nThreads, total, hot.getId(), nCold, [&](int eventId, int fanId) {
+            Event* e = resolve(eventId);
+            return e->bookEvent(fanId, regular).isValid();
+        });
+        double sharded = measure(nThreads, total, hot.getId(), nCold, [&](int eventId, int fanId) {
+            return shards.book(eventId, fanId, TicketType::Regular, payment).outcome == BookingOutcome::Booked;
+        });
+        atomic<int> done{0};
+        double async = measure(nThreads, total, hot.getId(), nCold, [&](int eventId, int fanId) {
+            shards.submit(eventId, fanId, TicketType::Regular, &payment, [&done](BookingResult) { done++; });
+            return true;
+        });
+        // measure() only timed the submissions, wait for the shards to finish them
+        auto start = chrono::steady_clock::now();
+        while (done < total) this_thread::yield();
+        async = 1 / (1 / async + chrono::duration<double>(chrono::steady_clock::now() - start).count() / total);
+
+        char line[128];
+        snprintf(line, sizeof(line), "%7d   %19.0f   %20.0f   %18.0f", nThreads, direct, sharded, async);
+        cout << line << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "Event.cpp"
+#include "PaymentService.cpp"
+#include "PaymentPipeline.cpp"
+
+using namespace std;
+
+enum class BookingOutcome {
+    Booked = 0,
+    EventNotFound,
+    EventFinished,
+    PaymentFailed,
+    SoldOut
+};
+
+struct BookingResult {
+    BookingOutcome outcome = BookingOutcome::EventNotFound;
+    Ticket ticket;
+    TicketTypePrice typePrice{TicketType::Regular, Money()};
+};
+
+// Booking requests partitioned by event: shard = eventId % N, each shard is one thread
+// (pinned to one core on Linux) with its own run queue and its own cache of the events it owns.
+// The requests of an event are checked and their tickets taken on its shard's thread, while events
+// on different shards are booked fully in parallel. Callers only meet on the queue of the shard
+// they submit to. The event's tiers are not the shard's alone: payment callbacks book or release
+// held tickets on PaymentPipeline workers, and CheckoutHolds holds and releases them on callers'
+// and its expiry thread, which is why tier quantities and seat maps stay atomic / locked.
+//
+// The events themselves stay in EventManager: a shard resolves an id through the resolver
+// (which takes whatever lock guards the managers) and keeps the Event* afterwards.
+// Note: a cached Event* is trusted while the generation (EventManager::getGeneration) has not
+// moved, any delete makes the shard resolve its events again. Without a generation the events
+// must never be deleted. With one, an event is deleted through closeEvent(): a booking pins its
+// event from before it is resolved until its payment callback is done, and closeEvent refuses new
+// pins and waits for the pinned bookings, so no Event* is used once its slot may be reused.
+//
+// Without a PaymentPipeline the shard takes the payment itself, inline. With one, the shard holds
+// the ticket and hands the payment to the pipeline, then moves on to its next request; the payment
+// callback books the held ticket (or gives it back), so a shard never waits on a payment gateway.
+// A charge that was approved but could not be booked (the TicketStore is full) is refunded.
+class BookingShards {
+public:
+    using Resolver = function<Event*(int eventId)>;
+    using Generation = function<uint64_t()>;
+
+    explicit BookingShards(Resolver resolver, unsigned nShards = thread::hardware_concurrency(),
+                           PaymentPipeline* payments = nullptr, Generation generation = nullptr)
+        : resolver(move(resolver)), generation(move(generation)), payments(payments) {
+        nShards = max(nShards, 1u);
+        for (unsigned i = 0; i < nShards; ++i) {
+            shards.emplace_back(new Shard());
+        }
+        for (unsigned i = 0; i < nShards; ++i) {
+            shards[i]->worker = thread([this, i] { run(*shards[i], i); });
+        }
+    }
+
+    ~BookingShards() {
+        for (auto& shard : shards) {
+            {
+                lock_guard<mutex> lock(shard->queueMutex);
+                shard->stopping = true;
+            }
+            shard->ready.notify_one();
+        }
+        for (auto& shard : shards) shard->worker.join();
+        // payment callbacks still running use their shard, they unpin last
+        for (auto& shard : shards) {
+            unique_lock<mutex> lock(shard->pinMutex);
+            shard->unpinned.wait(lock, [&shard] { return shard->pins.empty(); });
+        }
+    }
+
+    BookingShards(const BookingShards&) = delete;
+    BookingShards& operator=(const BookingShards&) = delete;
+
+    unsigned size() const { return (unsigned)shards.size(); }
+
+    unsigned shardOf(int eventId) const {
+        return (unsigned)eventId % shards.size();
+    }
+
+    // Queues the booking on the event's shard, done is called on the shard's thread
+    // (on a payment worker with a PaymentPipeline).
+    // The shard checks the event, takes the payment and books one ticket of the type.
+    void submit(int eventId, int fanId, TicketType type, PaymentMethod* payment, function<void(BookingResult)> done) {
+        Shard& shard = *shards[shardOf(eventId)];
+        {
+            lock_guard<mutex> lock(shard.queueMutex);
+            shard.queue.push_back(Request{eventId, fanId, type, payment, move(done)});
+        }
+        shard.ready.notify_one();
+    }
+
+    // Blocking form of submit
+    BookingResult book(int eventId, int fanId, TicketType type, PaymentMethod& payment) {
+        promise<BookingResult> result;
+        future<BookingResult> pending = result.get_future();
+        submit(eventId, fanId, type, &payment, [&result](BookingResult r) { result.set_value(move(r)); });
+        return pending.get();
+    }
+
+    // Runs remove (e.g. deleting the event) once no booking of the event is running: bookings that
+    // arrive meanwhile are refused as EventNotFound, the running ones finish (payment included) first
+    template <typename F>
+    auto closeEvent(int eventId, F remove) -> decltype(remove()) {
+        Shard& shard = *shards[shardOf(eventId)];
+        unique_lock<mutex> lock(shard.pinMutex);
+        shard.closing.insert(eventId);
+        shard.unpinned.wait(lock, [&shard, eventId] { return shard.pins.count(eventId) == 0; });
+        struct Reopen {
+            Shard& shard;
+            int eventId;
+            ~Reopen() { shard.closing.erase(eventId); }
+        } reopen{shard, eventId};
+        return remove();
+    }
+
+private:
+    struct Request {
+        int eventId;
+        int fanId;
+        TicketType type;
+        PaymentMethod* payment;
+        function<void(BookingResult)> done;
+    };
+
+    struct Shard {
+        mutex queueMutex;
+        condition_variable ready;
+        vector<Request> queue;
+        bool stopping = false;
+        thread worker;
+        // only touched by the shard's thread
+        struct Cached {
+            Event* event;
+            uint64_t generation;
+        };
+        unordered_map<int, Cached> events;
+        // bookings running per event, their Event* stays valid until they unpin it
+        mutex pinMutex;
+        condition_variable unpinned;
+        unordered_map<int, int> pins;
+        unordered_set<int> closing;
+    };
+
+    Resolver resolver;
+    Generation generation;
+    PaymentPipeline* payments;
+    vector<unique_ptr<Shard>> shards;
+
+    static void pinToCore(unsigned index) {
+#ifdef __linux__
+        unsigned cores = max(thread::hardware_concurrency(), 1u);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)index;
+#endif
+    }
+
+    bool pin(Shard& shard, int eventId) {
+        lock_guard<mutex> lock(shard.pinMutex);
+        if (shard.closing.count(eventId)) return false;
+        shard.pins[eventId]++;
+        return true;
+    }
+
+    void unpin(Shard& shard, int eventId) {
+        {
+            lock_guard<mutex> lock(shard.pinMutex);
+            auto it = shard.pins.find(eventId);
+            if (--it->second > 0) return;
+            shard.pins.erase(it);
+        }
+        shard.unpinned.notify_all();
+    }
+
+    // Caller pinned the event, a delete before the pin has moved the generation already
+    Event* ownedEvent(Shard& shard, int eventId) {
+        // read before resolving, a delete racing the resolver is caught by the next request
+        uint64_t now = generation ? generation() : 0;
+        auto it = shard.events.find(eventId);
+        if (it != shard.events.end() && it->second.generation == now)
+            return it->second.event;
+        Event* e = resolver(eventId);
+        if (e == nullptr) shard.events.erase(eventId);
+        else shard.events[eventId] = Shard::Cached{e, now};
+        return e;
+    }
+
+    void execute(Shard& shard, Request& req) {
+        BookingResult result;
+        if (!pin(shard, req.eventId)) return req.done(result);
+        Event* event = ownedEvent(shard, req.eventId);
+        if (event == nullptr) {
+            unpin(shard, req.eventId);
+            return req.done(result);
+        }
+        if (event->getEventStatus() == EventStatus::Finished) {
+            unpin(shard, req.eventId);
+            result.outcome = BookingOutcome::EventFinished;
+            return req.done(result);
+        }
+
+        result.typePrice.type = req.type;
+        switch (req.type) {
+            case TicketType::VIP: result.typePrice.price = event->getVipTickets().price; break;
+            case TicketType::Economic: result.typePrice.price = event->getEconomicTickets().price; break;
+            case TicketType::Regular: result.typePrice.price = event->getRegularTickets().price; break;
+        }
+
+        if (payments == nullptr) {
+            PaymentService paymentService;
+            paymentService.setPaymentMethod(req.payment);
+            if (!paymentService.processPayment(result.typePrice.price)) {
+                unpin(shard, req.eventId);
+                result.outcome = BookingOutcome::PaymentFailed;
+                return req.done(result);
+            }
+            result.ticket = event->bookEvent(req.fanId, result.typePrice);
+            unpin(shard, req.eventId);
+            // case booking is failed, the fan gets the charge back
+            if (!result.ticket.isValid()) {
+                paymentService.refundPayment(result.typePrice.price);
+                result.outcome = BookingOutcome::SoldOut;
+            } else {
+                result.outcome = BookingOutcome::Booked;
+            }
+            return req.done(result);
+        }
+
+        // the ticket is held before paying, a sold out tier is refused without charging the fan
+        SeatRange held;
+        if (!event->holdSeats(req.type, 1, held)) {
+            unpin(shard, req.eventId);
+            result.outcome = BookingOutcome::SoldOut;
+            return req.done(result);
+        }
+        int eventId = req.eventId;
+        int fanId = req.fanId;
+        PaymentMethod* payment = req.payment;
+        // the event stays pinned until the callback is done with it
+        payments->submit(payment, result.typePrice.price,
+            [this, &shard, event, eventId, held, fanId, payment, result, done = move(req.done)](bool approved) mutable {
+                vector<Ticket> booked;
+                if (approved) booked = event->bookHeldSeats(fanId, result.typePrice, held);
+                if (!booked.empty()) {
+                    result.ticket = booked[0];
+                    result.outcome = BookingOutcome::Booked;
+                } else if (approved) {
+                    // the TicketStore is full, the hold stood and goes back on sale, the charge is refunded
+                    event->releaseSeats(result.typePrice.type, held);
+                    payments->refund(payment, result.typePrice.price);
+                    result.outcome = BookingOutcome::SoldOut;
+                } else {
+                    event->releaseSeats(result.typePrice.type, held);
+                    result.outcome = BookingOutcome::PaymentFailed;
+                }
+                unpin(shard, eventId);
+                done(result);
+            });
+    }
+
+    void run(Shard& shard, unsigned index) {
+        pinToCore(index);
+        vector<Request> batch;
+        while (true) {
+            {
+                unique_lock<mutex> lock(shard.queueMutex);
+                shard.ready.wait(lock, [&shard] { return shard.stopping || !shard.queue.empty(); });
+                if (shard.queue.empty()) return; // stopping and drained
+                batch.swap(shard.queue);
+            }
+            // the whole batch runs without the queue lock, submitters are not held up meanwhile
+            for (Request& req : batch) {
+                execute(shard, req);
+            }
+            batch.clear();
+        }
+    }
+};
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <algorithm>
+
+#include "EventManager.cpp"
+#include "FanManager.cpp"
+#include "Json.cpp"
+
+using namespace std;
+
+enum class ImportFormat {
+    Csv = 1,   // first line is a header naming the columns, in any order
+    Jsonl = 2  // one flat JSON object per line
+};
+
+struct ImportStats {
+    size_t records = 0;     // non-empty data lines read
+    size_t imported = 0;
+    size_t invalid = 0;     // unparsable or rejected by the validators
+    size_t duplicates = 0;  // fans whose email is already registered
+    double seconds = 0;
+    vector<string> errors;  // first few problems as "line N: message"
+
+    double recordsPerSec() const {
+        return seconds > 0 ? records / seconds : 0;
+    }
+};
+
+// Reads a file block by block and hands out its lines, only one block is held in memory
+// so files larger than RAM can be streamed.
+class LineReader {
+private:
+    FILE* file = nullptr;
+    vector<char> block;
+    size_t pos = 0, len = 0;
+
+public:
+    explicit LineReader(const string& path, size_t blockSize = 1 << 20) : block(blockSize) {
+        file = fopen(path.c_str(), "rb");
+    }
+
+    ~LineReader() {
+        if (file) fclose(file);
+    }
+
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Next line without its line break, false at the end of the file
+    bool next(string& line) {
+        line.clear();
+        if (file == nullptr) return false;
+        bool any = false;
+        while (true) {
+            if (pos == len) {
+                len = fread(block.data(), 1, block.size(), file);
+                pos = 0;
+                if (len == 0) break;
+            }
+            any = true;
+            const char* start = block.data() + pos;
+            const char* nl = (const char*)memchr(start, '\n', len - pos);
+            if (nl != nullptr) {
+                line.append(start, nl);
+                pos += nl - start + 1;
+                break;
+            }
+            line.append(start, len - pos);
+            pos = len;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return any;
+    }
+};
+
+// Threads that run one job over every batch of an import, started once for the whole import
+// run(n) gives each thread one contiguous slice of [0, n) and returns when all slices are done.
+class BatchWorkers {
+public:
+    using Job = function<void(size_t from, size_t to)>;
+
+    BatchWorkers(unsigned count, Job job) : job(move(job)), count(max(count, 1u)) {
+        for (unsigned w = 0; w < this->count; ++w) pool.emplace_back([this, w] { loop(w); });
+    }
+
+    ~BatchWorkers() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        batchReady.notify_all();
+        for (thread& t : pool) t.join();
+    }
+
+    BatchWorkers(const BatchWorkers&) = delete;
+    BatchWorkers& operator=(const BatchWorkers&) = delete;
+
+    void run(size_t n) {
+        unique_lock<mutex> lock(m);
+        rows = n;
+        busy = count;
+        ++generation;
+        batchReady.notify_all();
+        batchDone.wait(lock, [this] { return busy == 0; });
+    }
+
+private:
+    Job job;
+    const unsigned count;
+    vector<thread> pool;
+    mutex m;
+    condition_variable batchReady;
+    condition_variable batchDone;
+    size_t rows = 0;
+    unsigned busy = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void loop(unsigned w) {
+        uint64_t seen = 0;
+        while (true) {
+            size_t n;
+            {
+                unique_lock<mutex> lock(m);
+                batchReady.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                n = rows;
+            }
+            size_t slice = (n + count - 1) / count;
+            size_t from = min(n, w * slice), to = min(n, from + slice);
+            if (from < to) job(from, to);
+            lock_guard<mutex> lock(m);
+            if (--busy == 0) batchDone.notify_one();
+        }
+    }
+};
+
+// Streaming bulk load of fans and events from CSV or JSONL files
+// The file is processed in batches of lines: a batch is parsed and validated by all cores,
+// then inserted with one call to the manager's bulk insert. Validation rules are passed in
+// (ValidationService lives with the UI), they must be safe to call from several threads.
+class BulkImporter {
+public:
+    using FanValidator = function<bool(const Fan&, string& error)>;
+    using EventValidator = function<bool(Event&, string& error)>;
+
+    // name,email,password,gender,phone
+    static const vector<string>& fanColumns() {
+        static const vector<string> columns = {"name", "email", "password", "gender", "phone"};
+        return columns;
+    }
+
+    // category is a name (Sports, Parties, ...) or its number
+    static const vector<string>& eventColumns() {
+        static const vector<string> columns = {
+            "name", "category", "day", "month", "year",
+            "vipPrice", "vipQuantity", "economicPrice", "economicQuantity", "regularPrice", "regularQuantity"
+        };
+        return columns;
+    }
+
+    explicit BulkImporter(size_t batchSize = 50000, unsigned threads = thread::hardware_concurrency())
+        : batchSize(max<size_t>(batchSize, 1)), threads(max(threads, 1u)) {}
+
+    bool importFans(const string& path, ImportFormat format, const FanValidator& validate, ImportStats& stats) {
+        FanManager& fanManager = FanManager::getInstance();
+        return run<Fan>(path, format, fanColumns(), stats,
+            [&](const vector<string>& v, Fan& fan, string& error) {
+                fan = Fan(v[0], v[1], v[2], v[3].empty() ? ' ' : v[3][0], v[4]);
+                return validate(fan, error);
+            },
+            [&](vector<Fan>& batch) {
+                size_t added = fanManager.addFans(batch);
+                stats.duplicates += batch.size() - added;
+                return added;
+            });
+    }
+
+    bool importEvents(const string& path, ImportFormat format, const EventValidator& validate, ImportStats& stats) {
+        EventManager& eventManager = EventManager::getInstance();
+        return run<Event>(path, format, eventColumns(), stats,
+            [&](const vector<string>& v, Event& event, string& error) {
+                Category category;
+                int day, month, year, vipQuantity, economicQuantity, regularQuantity;
+                Money vipPrice, economicPrice, regularPrice;
+                if (!parseCategory(v[1], category) || !parseInt(v[2], day, 1, 31) || !parseInt(v[3], month, 1, 12) ||
+                    !parseInt(v[4], year, 1, 9999) || !Money::parse(v[5], vipPrice) ||
+                    !parseInt(v[6], vipQuantity, 0, INT_MAX) || !Money::parse(v[7], economicPrice) ||
+                    !parseInt(v[8], economicQuantity, 0, INT_MAX) || !Money::parse(v[9], regularPrice) ||
+                    !parseInt(v[10], regularQuantity, 0, INT_MAX)) {
+                    error = "malformed or out of range number or category";
+                    return false;
+                }
+                event = Event(0, v[0], category, Date{day, month, year},
+                    TicketTypePriceQuantity{TicketType::VIP, vipPrice, vipQuantity},
+                    TicketTypePriceQuantity{TicketType::Economic, economicPrice, economicQuantity},
+                    TicketTypePriceQuantity{TicketType::Regular, regularPrice, regularQuantity});
+                return validate(event, error);
+            },
+            [&](vector<Event>& batch) {
+                eventManager.addEvents(batch);
+                return batch.size();
+            });
+    }
+
+    // ---------- Record parsing ----------
+
+    // Splits a CSV line, fields may be quoted with "" as an escaped quote
+    static bool splitCsv(const string& line, vector<string>& fields) {
+        fields.clear();
+        string field;
+        size_t i = 0;
+        while (true) {
+            field.clear();
+            if (i < line.size() && line[i] == '"') {
+                for (++i; ; ++i) {
+                    if (i >= line.size()) return false; // unterminated quote
+                    if (line[i] == '"') {
+                        if (i + 1 < line.size() && line[i + 1] == '"') { field += '"'; ++i; }
+                        else { ++i; break; }
+                    } else {
+                        field += line[i];
+                    }
+                }
+                if (i < line.size() && line[i] != ',') return false;
+            } else {
+                size_t comma = line.find(',', i);
+                if (comma == string::npos) comma = line.size();
+                field.assign(line, i, comma - i);
+                i = comma;
+            }
+            fields.push_back(field);
+            if (i >= line.size()) return true;
+            ++i; // skip the comma
+        }
+    }
+
+private:
+    size_t batchSize;
+    unsigned threads;
+
+    // A whole decimal number in [min, max], anything out of range fails instead of wrapping
+    static bool parseInt(const string& s, int& value, int min, int max) {
+        if (s.empty()) return false;
+        char* end;
+        errno = 0;
+        long v = strtol(s.c_str(), &end, 10);
+        if (*end != '\0' || errno == ERANGE || v < min || v > max) return false;
+        value = (int)v;
+        return true;
+    }
+
+    static bool parseCategory(const string& s, Category& category) {
+        static const pair<const char*, Category> names[] = {
+            {"Sports", Category::Sports}, {"Parties", Category::Parties},
+            {"Carnivals", Category::Carnivals}, {"Other", Category::Other}
+        };
+        for (const auto& n : names) {
+            if (s == n.first) { category = n.second; return true; }
+        }
+        int number;
+        if (!parseInt(s, number, 1, 4)) return false;
+        category = (Category)number;
+        return true;
+    }
+
+    // Row of one batch, filled by the worker threads
+    template <typename T>
+    struct Row {
+        size_t lineNo = 0;
+        string line;
+        T record;
+        bool valid = false;
+        string error;
+    };
+
+    // Shared pipeline: read a batch of lines, parse + validate it in parallel, insert the valid records
+    template <typename T, typename Parse, typename Insert>
+    bool run(const string& path, ImportFormat format, const vector<string>& columns,
+             ImportStats& stats, Parse parse, Insert insert) {
+        auto startTime = chrono::steady_clock::now();
+        LineReader reader(path);
+        if (!reader.isOpen()) return false;
+
+        // CSV header: column position in the file -> position in columns
+        vector<int> csvOrder;
+        size_t lineNo = 0;
+        string line;
+        if (format == ImportFormat::Csv) {
+            vector<string> header;
+            do {
+                if (!reader.next(line)) return false;
+                ++lineNo;
+            } while (line.empty());
+            if (!splitCsv(line, header)) return false;
+            for (const string& name : header) {
+                auto it = find(columns.begin(), columns.end(), name);
+                csvOrder.push_back(it == columns.end() ? -1 : (int)(it - columns.begin()));
+            }
+        }
+
+        vector<Row<T>> rows(batchSize);
+        vector<T> valid;
+        valid.reserve(batchSize);
+        auto work = [&](size_t from, size_t to) {
+            vector<string> fields, values;
+            for (size_t r = from; r < to; ++r) {
+                Row<T>& row = rows[r];
+                row.error.clear();
+                bool parsed;
+                if (format == ImportFormat::Jsonl) {
+                    parsed = Json::parseFlatObject(row.line, columns, values);
+                } else {
+                    parsed = splitCsv(row.line, fields) && fields.size() == csvOrder.size();
+                    values.assign(columns.size(), "");
+                    for (size_t f = 0; parsed && f < fields.size(); ++f) {
+                        if (csvOrder[f] != -1) values[csvOrder[f]] = fields[f];
+                    }
+                }
+                if (!parsed) {
+                    row.valid = false;
+                    row.error = "malformed record";
+                    continue;
+                }
+                row.valid = parse(values, row.record, row.error);
+            }
+        };
+
+        // started once for the whole import
+        unsigned nWorkers = (unsigned)min<size_t>(threads, (batchSize + 255) / 256);
+        unique_ptr<BatchWorkers> workers(nWorkers > 1 ? new BatchWorkers(nWorkers, work) : nullptr);
+
+        bool more = true;
+        while (more) {
+            size_t n = 0;
+            while (n < batchSize && (more = reader.next(rows[n].line))) {
+                ++lineNo;
+                if (rows[n].line.empty()) continue;
+                rows[n].lineNo = lineNo;
+                ++n;
+            }
+            if (n == 0) break;
+            stats.records += n;
+
+            // Parse + validate: each worker takes one contiguous slice of the batch, small batches
+            // are not worth waking them
+            if (workers && n > 256) {
+                workers->run(n);
+            } else {
+                work(0, n);
+            }
+
+            // Insert in file order so duplicates keep their first occurrence
+            valid.clear();
+            for (size_t r = 0; r < n; ++r) {
+                if (rows[r].valid) {
+                    valid.push_back(move(rows[r].record));
+                    continue;
+                }
+                stats.invalid++;
+                if (stats.errors.size() < 20)
+                    stats.errors.push_back("line " + to_string(rows[r].lineNo) + ": " + rows[r].error);
+            }
+            stats.imported += insert(valid);
+        }
+
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        return true;
+    }
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+#include "Event.cpp"
+#include "TimerWheel.cpp"
+
+using namespace std;
+
+// Tickets held for one fan while they check out
+struct HeldTickets {
+    int eventId = 0;
+    int fanId = 0;
+    TicketTypePrice typePrice{TicketType::Regular, Money()};
+    SeatRange range; // count only for a general admission tier
+};
+
+// Time-bounded holds on event inventory: hold() takes the tickets out of sale at once, take() hands
+// them to the checkout that confirms them, and a hold neither taken nor released within the TTL
+// gives its tickets back by itself. Expiry runs on a TimerWheel ticking every tickMs, so the cost
+// of a tick does not grow with the number of outstanding holds.
+//
+// Hold ids are [generation : 32][slot : 32] like the wheel's timer ids, a stale id finds nothing.
+// One mutex guards the table and the wheel; tickets are given back outside of it, through the
+// resolver, which runs the release on the event under the lock guarding the managers.
+class CheckoutHolds {
+public:
+    using Clock = chrono::steady_clock;
+    // Runs use on the event with the managers locked, not at all when the event was deleted
+    using Resolver = function<void(int eventId, const function<void(Event&)>& use)>;
+    static constexpr uint64_t NO_HOLD = 0;
+
+    CheckoutHolds(Resolver resolver, chrono::milliseconds ttl = chrono::minutes(10),
+                  chrono::milliseconds tick = chrono::milliseconds(100))
+        : resolver(move(resolver)), ttl(ttl), tick(tick), epoch(Clock::now()) {}
+
+    ~CheckoutHolds() { stop(); }
+
+    CheckoutHolds(const CheckoutHolds&) = delete;
+    CheckoutHolds& operator=(const CheckoutHolds&) = delete;
+
+    chrono::milliseconds getTtl() const { return ttl; }
+
+    // Background thread that expires holds as time passes, otherwise call expireUntil()
+    void start() {
+        lock_guard<mutex> lock(holdsMutex);
+        if (expirer.joinable()) return;
+        stopping = false;
+        expirer = thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            lock_guard<mutex> lock(holdsMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (expirer.joinable()) expirer.join();
+    }
+
+    // Holds n tickets of the type (adjacent seats on a numbered tier), NO_HOLD when there are not enough
+    // Caller keeps the event from being deleted meanwhile (holds the managers' lock)
+    uint64_t hold(Event& event, int fanId, TicketTypePrice typePrice, int n = 1) {
+        HeldTickets held{event.getId(), fanId, typePrice, SeatRange()};
+        if (!event.holdSeats(typePrice.type, n, held.range)) return NO_HOLD;
+
+        lock_guard<mutex> lock(holdsMutex);
+        uint32_t slot;
+        if (freeSlots.empty()) {
+            slot = (uint32_t)entries.size();
+            entries.push_back(Entry());
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        Entry& entry = entries[slot];
+        entry.held = held;
+        entry.active = true;
+        uint64_t id = ((uint64_t)entry.generation << 32) | slot;
+        // one tick late rather than early
+        uint64_t deadline = ticksAt(Clock::now() + ttl) + 1;
+        entry.timer = wheel.schedule(deadline > wheel.currentTick() ? deadline - wheel.currentTick() : 0, id);
+        return id;
+    }
+
+    // Removes the fan's hold and returns what it held, the caller then books or releases it
+    // false if the hold expired, was already taken or belongs to another fan
+    bool take(uint64_t holdId, int fanId, HeldTickets& held) {
+        lock_guard<mutex> lock(holdsMutex);
+        Entry* entry = find(holdId);
+        if (entry == nullptr || entry->held.fanId != fanId) return false;
+        wheel.cancel(entry->timer);
+        held = entry->held;
+        recycle((uint32_t)holdId);
+        return true;
+    }
+
+    // Gives the fan's held tickets back to sale before the TTL
+    bool release(uint64_t holdId, int fanId) {
+        HeldTickets held;
+        if (!take(holdId, fanId, held)) return false;
+        giveBack(held);
+        return true;
+    }
+
+    // Gives back the tickets of a hold taken with take() whose checkout failed
+    // Nothing to give back when the event was deleted, its tickets went with it
+    void giveBack(const HeldTickets& held) {
+        resolver(held.eventId, [&held](Event& event) { event.releaseSeats(held.typePrice.type, held.range); });
+    }
+
+    // Expires every hold whose TTL ended before time, returns how many
+    size_t expireUntil(Clock::time_point time) {
+        vector<HeldTickets> expired;
+        {
+            lock_guard<mutex> lock(holdsMutex);
+            wheel.advanceTo(ticksAt(time) + 1, [this, &expired](uint64_t holdId) {
+                expired.push_back(entries[(uint32_t)holdId].held);
+                recycle((uint32_t)holdId);
+            });
+        }
+        for (const HeldTickets& held : expired) giveBack(held);
+        return expired.size();
+    }
+
+    size_t size() {
+        lock_guard<mutex> lock(holdsMutex);
+        return wheel.size();
+    }
+
+private:
+    struct Entry {
+        HeldTickets held;
+        TimerWheel::TimerId timer = TimerWheel::NO_TIMER;
+        uint32_t generation = 1;
+        bool active = false;
+    };
+
+    Resolver resolver;
+    chrono::milliseconds ttl;
+    chrono::milliseconds tick;
+    Clock::time_point epoch;
+
+    mutex holdsMutex;
+    condition_variable wake;
+    bool stopping = false;
+    thread expirer;
+    TimerWheel wheel;
+    vector<Entry> entries;
+    vector<uint32_t> freeSlots;
+
+    uint64_t ticksAt(Clock::time_point time) const {
+        if (time <= epoch) return 0;
+        return (uint64_t)((time - epoch) / tick);
+    }
+
+    Entry* find(uint64_t holdId) {
+        uint32_t slot = (uint32_t)holdId;
+        if (slot >= entries.size()) return nullptr;
+        Entry& entry = entries[slot];
+        return entry.active && entry.generation == (uint32_t)(holdId >> 32) ? &entry : nullptr;
+    }
+
+    void recycle(uint32_t slot) {
+        entries[slot].active = false;
+        entries[slot].generation++;
+        freeSlots.push_back(slot);
+    }
+
+    void run() {
+        unique_lock<mutex> lock(holdsMutex);
+        while (!stopping) {
+            wake.wait_for(lock, tick);
+            if (stopping) break;
+            lock.unlock();
+            expireUntil(Clock::now());
+            lock.lock();
+        }
+    }
+};
@@ -4,8 +4,12 @@
 #include <string>
 #include <vector>
 #include <ctime>
+#include <atomic>
+#include <memory>
 
-#include "Ticket.cpp"
+#include "TicketStore.cpp"
+#include "TicketRowLog.cpp"
+#include "SeatMap.cpp"
 
 using namespace std;
 
@@ -18,10 +22,58 @@ enum class Category {
 
 struct TicketTypePriceQuantity {
     TicketType type;
-    double price;
+    Money price;
     int quantity;
 };
 
+// Inventory of one ticket tier inside an Event. quantity is only decremented
+// through compare-and-swap in Event::bookEvent, so concurrent buyers can never oversell.
+// A tier with numbered seats also has a seat map, quantity then counts its free seats.
+// held counts the tickets out of sale while a checkout holds them (not in quantity, not sold).
+struct TicketTier {
+    TicketType type = TicketType::Regular;
+    Money price;
+    atomic<int> quantity{0};
+    atomic<int> held{0};
+    unique_ptr<SeatMap> seats;
+
+    TicketTier() = default;
+    TicketTier(const TicketTypePriceQuantity& t) : type(t.type), price(t.price), quantity(t.quantity) {}
+    TicketTier(const TicketTier& other) { *this = other; }
+    TicketTier& operator=(const TicketTier& other) {
+        type = other.type;
+        price = other.price;
+        quantity.store(other.quantity.load());
+        held.store(other.held.load());
+        seats.reset(other.seats ? new SeatMap(*other.seats) : nullptr);
+        return *this;
+    }
+
+    // Keeps the assignment from a plain tier description
+    TicketTier& operator=(const TicketTypePriceQuantity& t) {
+        type = t.type;
+        price = t.price;
+        quantity.store(t.quantity);
+        held.store(0);
+        seats.reset();
+        return *this;
+    }
+
+    TicketTypePriceQuantity snapshot() const {
+        return TicketTypePriceQuantity{type, price, quantity.load()};
+    }
+
+    // Takes n tickets from the tier, fails without blocking when fewer are left
+    bool tryTake(int n = 1) {
+        int current = quantity.load();
+        while (current >= n && n > 0) {
+            if (quantity.compare_exchange_weak(current, current - n))
+                return true;
+        }
+        return false;
+    }
+};
+
 struct Date {
     int day, month, year;
 };
@@ -31,37 +83,99 @@ enum class EventStatus {
     Finished = 2
 };
 
+// Today's date as a yyyymmdd key. The system clock is read by refresh() (once per
+// EventStatusScheduler tick), status checks only read the cached key.
+class EventClock {
+private:
+    static atomic<int>& cached() {
+        static atomic<int> today{now()}; // Magic Static
+        return today;
+    }
+
+public:
+    static int dateKey(const Date& date) {
+        return date.year * 10000 + date.month * 100 + date.day;
+    }
+
+    // Reads the local date from the system clock
+    static int now() {
+        time_t t = time(nullptr);
+        tm today{};
+
+#ifdef _WIN32
+        localtime_s(&today, &t);
+#else
+        localtime_r(&t, &today);
+#endif
+
+        return (today.tm_year + 1900) * 10000 + (today.tm_mon + 1) * 100 + today.tm_mday;
+    }
+
+    static int today() { return cached().load(memory_order_relaxed); }
+
+    static int refresh() {
+        int key = now();
+        cached().store(key, memory_order_relaxed);
+        return key;
+    }
+
+    // Moves the cached date (tools that simulate days passing)
+    static void setToday(int key) { cached().store(key, memory_order_relaxed); }
+};
+
 class Event {
 private:
     int id = 0;
     string name;
     Category category = Category::Other;
-    int capacity;
-    int availableTickets;
-
-    vector<Ticket> tickets; // Composition: Event contains Tickets
-    TicketTypePriceQuantity vipTickets;
-    TicketTypePriceQuantity economicTickets;
-    TicketTypePriceQuantity regularTickets;
-    Date date;
+    int capacity = 0;
+    atomic<int> availableTickets{0};
+    // kept up to date by refreshStatus (date changes) and finish (the EventStatusScheduler)
+    atomic<EventStatus> status{EventStatus::Upcoming};
 
-    bool isPastDate(const Date& eventDate) const {
-        time_t t = time(nullptr);
-        tm today{};
+    // Booked tickets, kept in the TicketStore: only their rows are kept here (the upper half
+    // of each ticket's id is this event's id), appended without a lock
+    TicketRowLog ticketRows;
 
-        localtime_s(&today, &t); // Windows
-        // localtime_r(&t, &today); // Linux / macOS
+    TicketTier vipTickets{TicketTypePriceQuantity{TicketType::VIP, Money(), 0}};
+    TicketTier economicTickets{TicketTypePriceQuantity{TicketType::Economic, Money(), 0}};
+    TicketTier regularTickets{TicketTypePriceQuantity{TicketType::Regular, Money(), 0}};
+    Date date{};
 
-        // Compare year
-        if (eventDate.year < today.tm_year + 1900) return true;
-        if (eventDate.year > today.tm_year + 1900) return false;
+    TicketTier* getTier(TicketType type) {
+        switch (type) {
+            case TicketType::VIP:
+                return &vipTickets;
+            case TicketType::Economic:
+                return &economicTickets;
+            case TicketType::Regular:
+                return &regularTickets;
+            default:
+                return nullptr;
+        }
+    }
 
-        // Compare month
-        if (eventDate.month < today.tm_mon + 1) return true;
-        if (eventDate.month > today.tm_mon + 1) return false;
+    // Appends n tickets to the log, seat i of range going to ticket i when there is one
+    // Returns no tickets when the TicketStore or the event's row log is full, availableTickets is
+    // then left as it was and the caller gives the tier's tickets (and seats) back
+    vector<Ticket> recordTickets(int fanId, TicketTypePrice typePrice, const SeatRange* range, int n) {
+        vector<Ticket> created(n, Ticket(id, fanId, typePrice));
+        for (int i = 0; i < n; ++i) {
+            created[i].setTicketStatus(TicketStatus::Reserved);
+            if (range) created[i].setSeat(range->seat(i));
+        }
+        // the log slots are claimed first, so a stored ticket always has one
+        uint32_t slot;
+        if (!ticketRows.claim((uint32_t)n, slot)) return {};
+        if (!TicketStore::getInstance().append(created.data(), n)) return {};
+        availableTickets -= n;
+        for (int i = 0; i < n; ++i) ticketRows.set(slot + i, created[i].getRow());
+        return created;
+    }
 
-        // Compare day
-        return eventDate.day < today.tm_mday;
+    // Status of the date against the cached today, for a new or re-dated event
+    void refreshStatus() {
+        status = EventClock::dateKey(date) < EventClock::today() ? EventStatus::Finished : EventStatus::Upcoming;
     }
 
 public:
@@ -79,22 +193,78 @@ public:
         this->regularTickets = regularTickets;
         this->capacity = vipTickets.quantity + economicTickets.quantity + regularTickets.quantity;
         availableTickets = capacity;
+        refreshStatus();
+    }
+
+    // atomics and the ticket log are not copyable, copy their current values
+    Event(const Event& other) { *this = other; }
+
+    Event& operator=(const Event& other) {
+        if (this == &other) return *this;
+        id = other.id;
+        name = other.name;
+        category = other.category;
+        capacity = other.capacity;
+        availableTickets.store(other.availableTickets.load());
+        status.store(other.status.load());
+        vipTickets = other.vipTickets;
+        economicTickets = other.economicTickets;
+        regularTickets = other.regularTickets;
+        date = other.date;
+        ticketRows = other.ticketRows;
+        return *this;
     }
 
-    const TicketTypePriceQuantity &getVipTickets() const {
-        return vipTickets;
+    // Tiers are returned as snapshots since their quantities change under concurrent booking
+    TicketTypePriceQuantity getVipTickets() const {
+        return vipTickets.snapshot();
     }
 
-    const TicketTypePriceQuantity &getEconomicTickets() const {
-        return economicTickets;
+    TicketTypePriceQuantity getEconomicTickets() const {
+        return economicTickets.snapshot();
     }
 
-    const TicketTypePriceQuantity &getRegularTickets() const {
-        return regularTickets;
+    TicketTypePriceQuantity getRegularTickets() const {
+        return regularTickets.snapshot();
+    }
+
+    TicketTypePriceQuantity tierSnapshot(TicketType type) const {
+        return type == TicketType::VIP ? getVipTickets()
+            : type == TicketType::Economic ? getEconomicTickets() : getRegularTickets();
     }
 
     int getId() const { return id; }
 
+    int getCapacity() const { return capacity; }
+
+    // The booked tickets, read from the TicketStore
+    vector<Ticket> getTickets() const {
+        vector<uint64_t> ids = getTicketIds();
+        vector<Ticket> tickets(ids.size());
+        const TicketStore& store = TicketStore::getInstance();
+        for (size_t i = 0; i < ids.size(); ++i) store.get(ids[i], tickets[i]);
+        return tickets;
+    }
+
+    vector<uint64_t> getTicketIds() const {
+        vector<uint64_t> ids;
+        ids.reserve(ticketRows.size());
+        ticketRows.forEach([&](uint32_t row) { ids.push_back(Ticket::makeId(id, row)); });
+        return ids;
+    }
+
+    // Total paid for the booked tickets, each at the price it was sold at
+    Money getRevenue() const {
+        const TicketStore& store = TicketStore::getInstance();
+        Money total;
+        ticketRows.forEach([&](uint32_t row) { total += store.priceAt(row); });
+        return total;
+    }
+
+    size_t getTicketCount() const {
+        return ticketRows.size();
+    }
+
     string getName() const { return name; }
 
     Category getCategory() const {
@@ -113,70 +283,42 @@ public:
         return date.year;
     }
 
-    string getTicketPriceStr(TicketType type) const {
-        switch (type) {
-            case TicketType::VIP:
-                return to_string(vipTickets.price);
-            case TicketType::Regular:
-                return to_string(regularTickets.price);
-            case TicketType::Economic:
-                return to_string(economicTickets.price);
-            default:
-                return "0";
-        }
-    }
+    // One accessor per tier, so a form field can bind to a tier's price or quantity by member pointer
+    template <TicketType type>
+    Money getTierPrice() const { return tierSnapshot(type).price; }
 
-    string getTicketQuantityStr(TicketType type) const {
-        switch (type) {
-            case TicketType::VIP:
-                return to_string(vipTickets.quantity);
-            case TicketType::Regular:
-                return to_string(regularTickets.quantity);
-            case TicketType::Economic:
-                return to_string(economicTickets.quantity);
-            default:
-                return "0";
-        }
-    }
+    template <TicketType type>
+    int getTierQuantity() const { return tierSnapshot(type).quantity; }
+
+    template <TicketType type>
+    void setTierPrice(Money price) { setTicketPrice(type, price); }
+
+    template <TicketType type>
+    void setTierQuantity(int quantity) { setTicketQuantity(type, quantity); }
 
     void setDay(int day) {
         this->date.day = day;
+        refreshStatus();
     }
 
     void setMonth(int month) {
         this->date.month = month;
+        refreshStatus();
     }
 
     void setYear(int year) {
         this->date.year = year;
+        refreshStatus();
     }
 
-    void setTicketPrice(TicketType type, double price) {
-        switch (type) {
-            case TicketType::VIP:
-                vipTickets.price = price;
-                break;
-            case TicketType::Regular:
-                regularTickets.price = price;
-                break;
-            case TicketType::Economic:
-                economicTickets.price = price;
-                break;
-        }
+    void setTicketPrice(TicketType type, Money price) {
+        TicketTier* tier = getTier(type);
+        if (tier) tier->price = price;
     }
 
     void setTicketQuantity(TicketType type, int quantity) {
-        switch (type) {
-            case TicketType::VIP:
-                vipTickets.quantity = quantity;
-                break;
-            case TicketType::Regular:
-                regularTickets.quantity = quantity;
-                break;
-            case TicketType::Economic:
-                economicTickets.quantity = quantity;
-                break;
-        }
+        TicketTier* tier = getTier(type);
+        if (tier) tier->quantity = quantity;
 
         // keep totals consistent
         capacity = vipTickets.quantity +
@@ -190,6 +332,11 @@ public:
         this->id = id;
     }
 
+    // Used when restoring a stored event whose tiers already hold the remaining quantities
+    void setCapacity(int capacity) {
+        this->capacity = capacity;
+    }
+
     void setName(const string &name) {
         this->name = name;
     }
@@ -198,13 +345,28 @@ public:
         this->category = category;
     }
 
-    string dateToString(Date date) const {
+    // Takes an edited copy's name, category, date and tier prices and quantities (the admin's edit
+    // form, a logged edit); the tickets and seat maps stay as they are
+    void applyEdit(const Event& edited) {
+        setName(edited.getName());
+        setCategory(edited.getCategory());
+        setDay(edited.getDay());
+        setMonth(edited.getMonth());
+        setYear(edited.getYear());
+        for (const TicketTypePriceQuantity& tier : {edited.getVipTickets(), edited.getEconomicTickets(), edited.getRegularTickets()}) {
+            setTicketPrice(tier.type, tier.price);
+            setTicketQuantity(tier.type, tier.quantity);
+        }
+        setCapacity(edited.getCapacity());
+    }
+
+    static string dateToString(Date date) {
         string d = (date.day < 10 ? "0" : "") + to_string(date.day);
         string m = (date.month < 10 ? "0" : "") + to_string(date.month);
         return d + "-" + m + "-" + to_string(date.year);
     }
 
-    string categoryToString(Category category) const {
+    static string categoryToString(Category category) {
         switch (category) {
             case Category::Sports:
                 return "Sports";
@@ -219,65 +381,139 @@ public:
         }
     }
 
-    // Logic to link fan to ticket
-    // Note if returned ticket has id="0" , then booking operation is failed
+    // Logic to link fan to ticket, safe to call from many threads at once
+    // A tier with numbered seats gives the ticket the best free seat
+    // Note if the returned ticket is not valid (isValid() false), then booking operation is failed
     Ticket bookEvent(int fanId, TicketTypePrice typePrice) {
-        Ticket createdTicket;
-        switch (typePrice.type) {
-            case TicketType::VIP:
-                if (vipTickets.quantity <= 0) {
-                    return Ticket();
-                }
-                vipTickets.quantity--;
-                break;
-            case TicketType::Economic:
-                if (economicTickets.quantity <= 0) {
-                    return Ticket();
-                }
-                economicTickets.quantity--;
-                break;
-            case TicketType::Regular:
-                if (regularTickets.quantity <= 0) {
-                    return Ticket();
-                }
-                regularTickets.quantity--;
-                break;
-            default:
-                return Ticket();
-                break;
+        vector<Ticket> booked = bookEvent(fanId, typePrice, 1);
+        return booked.empty() ? Ticket() : booked[0];
+    }
+
+    // Books n tickets at once, on numbered tiers n adjacent seats in one row (one ticket per seat)
+    // Returns no tickets if the tier has fewer than n left or no n adjacent seats are free
+    vector<Ticket> bookEvent(int fanId, TicketTypePrice typePrice, int n) {
+        TicketTier* tier = getTier(typePrice.type);
+        // Sold out requests are rejected by the CAS loop without taking any lock
+        if (tier == nullptr || !tier->tryTake(n)) {
+            return {};
+        }
+        SeatRange range;
+        if (tier->seats && !tier->seats->allocate(n, range)) {
+            tier->quantity += n;
+            return {};
+        }
+        vector<Ticket> booked = recordTickets(fanId, typePrice, tier->seats ? &range : nullptr, n);
+        if (booked.empty()) {
+            if (tier->seats) tier->seats->release(range);
+            tier->quantity += n;
         }
-        availableTickets--;
+        return booked;
+    }
 
-        createdTicket.setId(to_string(tickets.size() + 1));
-        createdTicket.setFanId(fanId);
-        createdTicket.setEventId(id);
-        createdTicket.setTicketTypePrice(typePrice);
-        createdTicket.setTicketStatus(TicketStatus::Reserved);
+    // Numbered seats for a tier, replacing its quantity with the layout's seat count
+    // An empty layout turns the tier back into general admission
+    void setSeatMap(TicketType type, const SeatLayout& layout) {
+        TicketTier* tier = getTier(type);
+        if (tier == nullptr) return;
+        tier->seats.reset(layout.empty() ? nullptr : new SeatMap(layout));
+        if (tier->seats) setTicketQuantity(type, layout.seatCount());
+    }
 
-        tickets.push_back(createdTicket);
-        return createdTicket;
+    // nullptr for a general admission tier
+    const SeatMap* getSeatMap(TicketType type) const {
+        switch (type) {
+            case TicketType::VIP: return vipTickets.seats.get();
+            case TicketType::Economic: return economicTickets.seats.get();
+            case TicketType::Regular: return regularTickets.seats.get();
+            default: return nullptr;
+        }
     }
 
-    string viewDetailsBreifly() const {
+    // Holds n tickets (e.g. while the buyer pays), the best n adjacent seats on a numbered tier
+    // and just a count on a general admission one (held.section = -1)
+    // They stay out of sale until bookHeldSeats or releaseSeats
+    bool holdSeats(TicketType type, int n, SeatRange& held) {
+        TicketTier* tier = getTier(type);
+        if (tier == nullptr || !tier->tryTake(n)) return false;
+        if (!tier->seats) {
+            held = SeatRange{-1, -1, -1, n};
+        } else if (!tier->seats->allocate(n, held)) {
+            tier->quantity += n;
+            return false;
+        }
+        tier->held += n;
+        return true;
+    }
+
+    // Holds the given seats of a numbered tier, fails if any of them is held or sold
+    bool holdSeats(TicketType type, const SeatRange& range) {
+        TicketTier* tier = getTier(type);
+        if (tier == nullptr || !tier->seats || !tier->tryTake(range.count)) return false;
+        if (!tier->seats->hold(range)) {
+            tier->quantity += range.count;
+            return false;
+        }
+        tier->held += range.count;
+        return true;
+    }
+
+    void releaseSeats(TicketType type, const SeatRange& held) {
+        TicketTier* tier = getTier(type);
+        if (tier == nullptr) return;
+        if (tier->seats && held.section >= 0) tier->seats->release(held);
+        tier->held -= held.count;
+        tier->quantity += held.count;
+    }
+
+    // Turns tickets held by holdSeats into booked tickets
+    // Returns no tickets if they could not be stored, the hold then stands until releaseSeats
+    vector<Ticket> bookHeldSeats(int fanId, TicketTypePrice typePrice, const SeatRange& held) {
+        TicketTier* tier = getTier(typePrice.type);
+        if (tier == nullptr) return {};
+        vector<Ticket> booked = recordTickets(fanId, typePrice, held.section >= 0 ? &held : nullptr, held.count);
+        if (!booked.empty()) tier->held -= held.count;
+        return booked;
+    }
+
+    // Tickets of the tier currently held by checkouts
+    int getHeldTickets(TicketType type) const {
+        switch (type) {
+            case TicketType::VIP: return vipTickets.held;
+            case TicketType::Economic: return economicTickets.held;
+            case TicketType::Regular: return regularTickets.held;
+            default: return 0;
+        }
+    }
+
+    // Also built from a copy of the fields (the console lists an EventView's)
+    static string viewDetailsBreifly(int id, const string& name, Category category, Date date) {
         return "Event #"+to_string(id)+", Name: "+name+", Category: "+categoryToString(category)+", Date: "+dateToString(date);
     }
 
+    string viewDetailsBreifly() const {
+        return viewDetailsBreifly(id, name, category, date);
+    }
+
     string viewDetails() const {
         return "  Event #" + to_string(id) + "\n  Name: " + name + "\n  Category: " + categoryToString(category) +
             "\n  Date: " + dateToString(date) + "\n  Total Seats: " + to_string(capacity) + "\n  Available Seats: " +
             to_string(availableTickets) + "\n  Event Status: " + eventStatustoStr(getEventStatus()) 
-            + "\n  VIP Ticket Price: " + to_string(vipTickets.price) + " , VIP Available Tickets: " +
+            + "\n  VIP Ticket Price: " + vipTickets.price.toString() + " , VIP Available Tickets: " +
             to_string(vipTickets.quantity)
-            + "\n  Regular Ticket Price: " + to_string(regularTickets.price) + " , Regular Available Tickets: " +
+            + "\n  Regular Ticket Price: " + regularTickets.price.toString() + " , Regular Available Tickets: " +
             to_string(regularTickets.quantity)
-            + "\n  Economic Ticket Price: " + to_string(economicTickets.price) + " , Economic Available Tickets: " +
+            + "\n  Economic Ticket Price: " + economicTickets.price.toString() + " , Economic Available Tickets: " +
             to_string(economicTickets.quantity);
     }
 
+    // A field load, the EventStatusScheduler flips it when the date passes
     EventStatus getEventStatus() const {
-        return isPastDate(date)
-            ? EventStatus::Finished
-            : EventStatus::Upcoming;
+        return status.load(memory_order_relaxed);
+    }
+
+    // The event's date has passed, its tickets are expired later by the TicketExpirySweeper
+    void finish() {
+        status = EventStatus::Finished;
     }
 
     string eventStatustoStr(const EventStatus& eventStatus) const {
@@ -291,12 +527,37 @@ public:
         }
     }
 
-    void expireTickets() {
-        for (int i = 0; i < tickets.size(); i++) {
-            tickets[i].setTicketStatus(TicketStatus::Expired);
+    // Replays a logged booking: takes the ticket (and its seat) out of sale again and stores it
+    // under its logged id, or a new one when the log did not record it
+    bool rebook(Ticket& t) {
+        Seat seat = t.getSeat();
+        TicketType type = t.getTypePrice().type;
+        SeatRange range{seat.section, seat.row, seat.number, 1};
+        if (!(seat.isAssigned() ? holdSeats(type, range) : holdSeats(type, 1, range))) return false;
+        TicketStore& store = TicketStore::getInstance();
+        uint32_t slot;
+        if (!ticketRows.claim(1, slot) || !(t.getRow() == 0 ? store.append(&t, 1) : store.restore(t))) {
+            releaseSeats(type, range);
+            return false;
         }
+        getTier(type)->held -= 1;
+        availableTickets -= 1;
+        ticketRows.set(slot, t.getRow());
+        return true;
     }
 
-    // Helper to populate tickets
-    void addTicket(Ticket t) { tickets.push_back(t); }
+    // Helper to populate tickets, a restored ticket's seat is marked as sold
+    // A ticket that is not in the TicketStore yet (row 0) is stored first, its id is set
+    // Returns false (nothing added) when the TicketStore or the row log is full
+    bool addTicket(Ticket& t) {
+        uint32_t slot;
+        if (!ticketRows.claim(1, slot)) return false;
+        if (t.getRow() == 0 && !TicketStore::getInstance().append(&t, 1)) return false;
+        TicketTier* tier = getTier(t.getTypePrice().type);
+        Seat seat = t.getSeat();
+        if (tier && tier->seats && seat.isAssigned())
+            tier->seats->hold(SeatRange{seat.section, seat.row, seat.number, 1});
+        ticketRows.set(slot, t.getRow());
+        return true;
+    }
 };
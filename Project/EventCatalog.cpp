@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Event.cpp"
+
+using namespace std;
+
+// ---------- On-disk layout ----------
+// [CatalogHeader][EventRecord x eventCount, sorted by id][string pool]
+// Every record is plain data so the file is used straight from the mapping, no parsing.
+
+struct CatalogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t eventCount;
+    uint64_t poolSize;
+};
+
+struct CatalogTier {
+    int64_t price; // piastres
+    int32_t quantity;
+    int32_t type;
+};
+
+struct EventRecord {
+    int32_t id;
+    int32_t category;
+    int32_t day, month, year;
+    int32_t capacity;
+    uint32_t nameOffset; // into the string pool
+    uint32_t nameLength;
+    CatalogTier tiers[3]; // VIP, Economic, Regular
+};
+
+static_assert(is_trivially_copyable<CatalogHeader>::value, "catalog header must be POD");
+static_assert(is_trivially_copyable<EventRecord>::value, "catalog records must be POD");
+
+// Read-only, memory-mapped event catalog
+// Opening only maps the file, records are read in place when an event is requested,
+// so startup does not depend on the number of events and the pages are shared
+// between processes mapping the same file.
+class EventCatalog {
+private:
+    static constexpr char MAGIC[8] = {'T', 'K', 'C', 'A', 'T', 'L', 'G', '1'};
+    // 2: tier prices in piastres, only this version is opened
+    static constexpr uint32_t VERSION = 2;
+
+    const char* base = nullptr;
+    size_t fileSize = 0;
+    const CatalogHeader* header = nullptr;
+    const EventRecord* records = nullptr;
+    const char* pool = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    static CatalogTier toRecordTier(const TicketTypePriceQuantity& t) {
+        return CatalogTier{t.price.piastres(), t.quantity, (int32_t)t.type};
+    }
+
+    static TicketTypePriceQuantity fromRecordTier(const CatalogTier& t) {
+        return TicketTypePriceQuantity{(TicketType)t.type, Money::fromPiastres(t.price), t.quantity};
+    }
+
+    bool mapFile(const string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return false;
+        fileSize = (size_t)size.QuadPart;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) return false;
+        base = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        return base != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        fileSize = (size_t)st.st_size;
+        void* p = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (p == MAP_FAILED) return false;
+        base = (const char*)p;
+        return true;
+#endif
+    }
+
+public:
+    EventCatalog() = default;
+    ~EventCatalog() { close(); }
+
+    // Disable copy & assignment, the object owns the mapping
+    EventCatalog(const EventCatalog&) = delete;
+    EventCatalog& operator=(const EventCatalog&) = delete;
+
+    // Maps the catalog file, returns false if it is missing or malformed
+    bool open(const string& path) {
+        close();
+        if (!mapFile(path)) {
+            close();
+            return false;
+        }
+
+        // sizes are compared by subtraction, so a huge count or pool size cannot wrap into a match
+        header = (const CatalogHeader*)base;
+        size_t recordsSize = fileSize >= sizeof(CatalogHeader)
+            ? (size_t)header->eventCount * sizeof(EventRecord) : 0;
+        if (fileSize < sizeof(CatalogHeader) ||
+            memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+            recordsSize > fileSize - sizeof(CatalogHeader) ||
+            header->poolSize != fileSize - sizeof(CatalogHeader) - recordsSize) {
+            close();
+            return false;
+        }
+
+        records = (const EventRecord*)(base + sizeof(CatalogHeader));
+        pool = base + sizeof(CatalogHeader) + recordsSize;
+        return true;
+    }
+
+    void close() {
+        if (base != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(base);
+#else
+            munmap((void*)base, fileSize);
+#endif
+        }
+#ifdef _WIN32
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#endif
+        base = nullptr;
+        fileSize = 0;
+        header = nullptr;
+        records = nullptr;
+        pool = nullptr;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    int size() const { return header ? (int)header->eventCount : 0; }
+
+    const EventRecord& getRecord(int index) const { return records[index]; }
+
+    int maxId() const { return size() ? records[size() - 1].id : 0; }
+
+    // Index of the record with this id or -1, binary search since records are sorted by id
+    int find(int id) const {
+        const EventRecord* end = records + size();
+        const EventRecord* it = lower_bound(records, end, id,
+            [](const EventRecord& r, int id) { return r.id < id; });
+        if (it != end && it->id == id)
+            return (int)(it - records);
+        return -1;
+    }
+
+    // Name straight from the mapped string pool, checked against the pool's bounds here rather
+    // than for every record at open; a corrupt record reads as an empty name
+    string getName(int index) const {
+        const EventRecord& r = records[index];
+        if (r.nameOffset > header->poolSize || r.nameLength > header->poolSize - r.nameOffset) return string();
+        return string(pool + r.nameOffset, r.nameLength);
+    }
+
+    // Builds a regular Event out of a mapped record
+    Event toEvent(int index) const {
+        const EventRecord& r = records[index];
+        Event e(r.id, getName(index), (Category)r.category, Date{r.day, r.month, r.year},
+            fromRecordTier(r.tiers[0]), fromRecordTier(r.tiers[1]), fromRecordTier(r.tiers[2]));
+        e.setCapacity(r.capacity);
+        return e;
+    }
+
+    // Publishes events as a catalog file, written to a temp file first then renamed
+    static bool write(const string& path, vector<const Event*> events) {
+        sort(events.begin(), events.end(),
+            [](const Event* a, const Event* b) { return a->getId() < b->getId(); });
+
+        vector<EventRecord> recs;
+        recs.reserve(events.size());
+        string stringPool;
+        for (const Event* e : events) {
+            EventRecord r{};
+            r.id = e->getId();
+            r.category = (int32_t)e->getCategory();
+            r.day = e->getDay();
+            r.month = e->getMonth();
+            r.year = e->getYear();
+            r.capacity = e->getCapacity();
+            string name = e->getName();
+            r.nameOffset = (uint32_t)stringPool.size();
+            r.nameLength = (uint32_t)name.size();
+            stringPool += name;
+            r.tiers[0] = toRecordTier(e->getVipTickets());
+            r.tiers[1] = toRecordTier(e->getEconomicTickets());
+            r.tiers[2] = toRecordTier(e->getRegularTickets());
+            recs.push_back(r);
+        }
+
+        CatalogHeader h{};
+        memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version = VERSION;
+        h.eventCount = (uint32_t)recs.size();
+        h.poolSize = stringPool.size();
+
+        string tmpPath = path + ".tmp";
+        FILE* f = fopen(tmpPath.c_str(), "wb");
+        if (f == nullptr) return false;
+        bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+            fwrite(recs.data(), sizeof(EventRecord), recs.size(), f) == recs.size() &&
+            fwrite(stringPool.data(), 1, stringPool.size(), f) == stringPool.size();
+        ok = (fclose(f) == 0) && ok;
+        if (!ok) return false;
+
+        remove(path.c_str());
+        return rename(tmpPath.c_str(), path.c_str()) == 0;
+    }
+};
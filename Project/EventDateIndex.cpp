@@ -0,0 +1,109 @@
+#pragma once
+
+#include <climits>
+#include <set>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+#include "Event.cpp"
+
+using namespace std;
+
+// Events ordered by date, overall and per Category
+// Entries are (date key, event id) so a date range is one ordered slice of a set,
+// and queries hand out Ranges over that slice instead of copying events.
+class EventDateIndex {
+public:
+    using Entries = set<pair<int, int>>;
+
+    // Non-owning view over a slice of the index, iterates event ids in date order
+    // Note: it is invalidated by the next change to the index (add/remove/update)
+    class Range {
+    private:
+        Entries::const_iterator first, last;
+
+    public:
+        class iterator {
+        private:
+            Entries::const_iterator it;
+
+        public:
+            using iterator_category = forward_iterator_tag;
+            using value_type = int;
+            using difference_type = ptrdiff_t;
+            using pointer = const int*;
+            using reference = const int&;
+
+            explicit iterator(Entries::const_iterator it) : it(it) {}
+            const int& operator*() const { return it->second; }
+            iterator& operator++() { ++it; return *this; }
+            bool operator==(const iterator& other) const { return it == other.it; }
+            bool operator!=(const iterator& other) const { return it != other.it; }
+        };
+
+        Range(Entries::const_iterator first, Entries::const_iterator last) : first(first), last(last) {}
+
+        iterator begin() const { return iterator(first); }
+        iterator end() const { return iterator(last); }
+        bool empty() const { return first == last; }
+    };
+
+    static int dateKey(const Date& date) {
+        return EventClock::dateKey(date);
+    }
+
+    void add(int id, Category category, const Date& date) {
+        int key = dateKey(date);
+        all.insert({key, id});
+        byCategory[category].insert({key, id});
+        keys[id] = {category, key};
+    }
+
+    void remove(int id) {
+        auto it = keys.find(id);
+        if (it == keys.end()) return;
+        all.erase({it->second.second, id});
+        byCategory[it->second.first].erase({it->second.second, id});
+        keys.erase(it);
+    }
+
+    // Unchanged entries are left alone, so loading an event while iterating a Range is safe
+    void update(int id, Category category, const Date& date) {
+        auto it = keys.find(id);
+        if (it != keys.end() && it->second == make_pair(category, dateKey(date))) return;
+        remove(id);
+        add(id, category, date);
+    }
+
+    // Events dated from..to (both included)
+    Range between(const Date& from, const Date& to) const {
+        return slice(all, from, to);
+    }
+
+    Range inCategory(Category category) const {
+        auto it = byCategory.find(category);
+        if (it == byCategory.end()) return Range(empty.end(), empty.end());
+        return Range(it->second.begin(), it->second.end());
+    }
+
+    // Events of one category dated from..to (both included)
+    Range inCategory(Category category, const Date& from, const Date& to) const {
+        auto it = byCategory.find(category);
+        if (it == byCategory.end()) return Range(empty.end(), empty.end());
+        return slice(it->second, from, to);
+    }
+
+private:
+    Entries all;
+    unordered_map<Category, Entries> byCategory;
+    // id -> (category, date key) of its current entries
+    unordered_map<int, pair<Category, int>> keys;
+    const Entries empty;
+
+    static Range slice(const Entries& entries, const Date& from, const Date& to) {
+        auto first = entries.lower_bound({dateKey(from), INT_MIN});
+        if (dateKey(from) > dateKey(to)) return Range(first, first);
+        return Range(first, entries.upper_bound({dateKey(to), INT_MAX}));
+    }
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Event.cpp"
+#include "FormSchema.cpp"
+
+using namespace std;
+
+// Fields of the add and edit event forms, bound to Event's setters and getters
+inline constexpr auto EVENT_FORM = makeForm<Event>(
+    field("Event Name:", 30, "A-Za-z ", &Event::setName, &Event::getName),
+    // -------- DATE --------
+    field("Day:", 2, "0-9", &Event::setDay, &Event::getDay),
+    field("Month:", 2, "0-9", &Event::setMonth, &Event::getMonth),
+    field("Year:", 4, "0-9", &Event::setYear, &Event::getYear),
+    // -------- VIP TICKETS --------
+    field("VIP Ticket Price:", 7, "0-9.", &Event::setTierPrice<TicketType::VIP>, &Event::getTierPrice<TicketType::VIP>),
+    field("VIP Ticket Quantity:", 6, "0-9", &Event::setTierQuantity<TicketType::VIP>,
+          &Event::getTierQuantity<TicketType::VIP>),
+    // -------- REGULAR TICKETS --------
+    field("Regular Ticket Price:", 7, "0-9.", &Event::setTierPrice<TicketType::Regular>,
+          &Event::getTierPrice<TicketType::Regular>),
+    field("Regular Ticket Quantity:", 6, "0-9", &Event::setTierQuantity<TicketType::Regular>,
+          &Event::getTierQuantity<TicketType::Regular>),
+    // -------- ECONOMIC TICKETS --------
+    field("Economic Ticket Price:", 7, "0-9.", &Event::setTierPrice<TicketType::Economic>,
+          &Event::getTierPrice<TicketType::Economic>),
+    field("Economic Ticket Quantity:", 6, "0-9", &Event::setTierQuantity<TicketType::Economic>,
+          &Event::getTierQuantity<TicketType::Economic>)
+);
+static_assert(EVENT_FORM.isValid(), "an event form field is longer than MAX_FIELD_LEN");
@@ -1,14 +1,110 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <string>
+#include <unordered_map>
 #include <algorithm>
+#include <atomic>
 #include "Event.cpp"
+#include "EventCatalog.cpp"
+#include "EventSearchIndex.cpp"
+#include "EventDateIndex.cpp"
+#include "EventStatusScheduler.cpp"
 
 // Singleton Class for Events
 class EventManager {
 private:
-    vector<Event> events;
+    // Slot storage: deque never relocates its elements, so an Event* from getEvent()
+    // stays valid until that event is deleted. Deleted slots become tombstones (id 0)
+    // and are reused by the next addEvent through freeSlots.
+    deque<Event> slots;
+    vector<size_t> freeSlots;
+
+    // id -> slot index of live events
+    unordered_map<int, size_t> idIndex;
+    int nextId = 1;
+
+    // Bumped by every delete, an Event* cached by another thread is stale once it moves
+    atomic<uint64_t> generation{0};
+
+    // Optional read-only base layer. Catalog events are moved into slots the first time
+    // they are requested; catalogLoaded marks records already moved, replaced or deleted.
+    EventCatalog catalog;
+    vector<bool> catalogLoaded;
+    int catalogPending = 0;
+
+    // Secondary indexes, catalog events are only indexed on the first query so attaching stays instant
+    EventSearchIndex nameIndex;
+    EventDateIndex dateIndex;
+    bool catalogIndexed = false;
+
+    // Flips events in slots to Finished when their date passes, catalog events get their status when loaded
+    // An event added with a past date is already Finished, its tickets expire at the next tick
+    EventStatusScheduler statusScheduler;
+
+    void indexEvent(const Event& e) {
+        Date date{e.getDay(), e.getMonth(), e.getYear()};
+        nameIndex.update(e.getId(), e.getName());
+        dateIndex.update(e.getId(), e.getCategory(), date);
+        statusScheduler.schedule(e.getId(), date);
+    }
+
+    void unindexEvent(int eventId) {
+        nameIndex.remove(eventId);
+        dateIndex.remove(eventId);
+    }
+
+    void indexCatalog() {
+        if (catalogIndexed) return;
+        for (int i = 0; i < catalog.size(); ++i) {
+            if (catalogLoaded[i]) continue;
+            const EventRecord& r = catalog.getRecord(i);
+            nameIndex.add(r.id, catalog.getName(i));
+            dateIndex.add(r.id, (Category)r.category, Date{r.day, r.month, r.year});
+        }
+        catalogIndexed = true;
+    }
+
+    Event* loadFromCatalog(int index) {
+        catalogLoaded[index] = true;
+        catalogPending--;
+        Event e = catalog.toEvent(index);
+        insertEvent(e);
+        return &slots[idIndex[e.getId()]];
+    }
+
+    // Marks a catalog record as overridden by the slots
+    void shadowCatalog(int eventId) {
+        if (!catalog.isOpen()) return;
+        int index = catalog.find(eventId);
+        if (index != -1 && !catalogLoaded[index]) {
+            catalogLoaded[index] = true;
+            catalogPending--;
+        }
+    }
+
+    void insertEvent(Event& e) {
+        // Re-adding an existing id replaces it in place
+        auto it = idIndex.find(e.getId());
+        if (it != idIndex.end()) {
+            slots[it->second] = e;
+            indexEvent(e);
+            return;
+        }
+
+        size_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            slots[slot] = e;
+        } else {
+            slot = slots.size();
+            slots.push_back(e);
+        }
+        idIndex[e.getId()] = slot;
+        indexEvent(e);
+    }
 
     // Private constructor
     EventManager() = default;
@@ -23,36 +119,169 @@ public:
         return instance;
     }
 
+    // Maps a catalog file written by EventCatalog::write, its events are served lazily
+    bool attachCatalog(const string& path) {
+        if (!catalog.open(path))
+            return false;
+        catalogLoaded.assign(catalog.size(), false);
+        catalogPending = catalog.size();
+        catalogIndexed = false;
+        nextId = max(nextId, catalog.maxId() + 1);
+
+        // events added before attaching win over the catalog
+        for (auto& entry : idIndex) {
+            shadowCatalog(entry.first);
+        }
+        return true;
+    }
+
     void addEvent(Event& e) {
         if (e.getId() == 0)
-            e.setId(events.size() + 1);
-        events.push_back(e);
+            e.setId(nextId);
+        nextId = max(nextId, e.getId() + 1);
+
+        shadowCatalog(e.getId());
+        insertEvent(e);
+    }
+
+    // Bulk insert: the id index is grown once for the whole batch, ids are assigned like addEvent
+    void addEvents(vector<Event>& batch) {
+        idIndex.reserve(idIndex.size() + batch.size());
+        for (Event& e : batch) {
+            addEvent(e);
+        }
     }
 
     bool deleteEvent(int eventId){
-        auto it = remove_if(events.begin(), events.end(),
-            [eventId](Event& e){ return e.getId() == eventId; });
-        if(it != events.end()){
-            events.erase(it, events.end());
+        auto it = idIndex.find(eventId);
+        if (it == idIndex.end()) {
+            // never loaded catalog event
+            int index = catalog.isOpen() ? catalog.find(eventId) : -1;
+            if (index == -1 || catalogLoaded[index])
+                return false;
+            shadowCatalog(eventId);
+            unindexEvent(eventId);
             return true;
         }
-        return false;
+
+        // Leave a tombstone (id 0) and release its name/tickets memory
+        slots[it->second] = Event();
+        freeSlots.push_back(it->second);
+        idIndex.erase(it);
+        unindexEvent(eventId);
+        generation.fetch_add(1, memory_order_release);
+        return true;
+    }
+
+    // Read without a lock by threads that cache Event* (BookingShards): when it has not moved
+    // since an event was looked up, no event was deleted and no slot reused meanwhile
+    uint64_t getGeneration() const {
+        return generation.load(memory_order_acquire);
+    }
+
+    // Must be called after an event is edited in place (through getEvent) so queries see its new name/category/date
+    void reindexEvent(const Event& e) {
+        if (idIndex.count(e.getId()))
+            indexEvent(e);
+    }
+
+    // Reads today's date from the clock and finishes the events dated before it; call it
+    // periodically (TicketakService does every minute). Returns how many finished and appends
+    // their ids to finished, whose tickets the caller hands to a TicketExpirySweeper.
+    size_t updateStatuses(vector<int>* finished = nullptr) {
+        return advanceStatuses(EventClock::refresh(), finished);
+    }
+
+    // Same with an explicit today (yyyymmdd key), which becomes EventClock's date
+    size_t advanceStatuses(int today, vector<int>* finished = nullptr) {
+        EventClock::setToday(today);
+        return statusScheduler.advanceTo(today, [this, today, finished](int eventId) {
+            auto it = idIndex.find(eventId);
+            if (it == idIndex.end()) return false;
+            Event& e = slots[it->second];
+            Date date{e.getDay(), e.getMonth(), e.getYear()};
+            if (EventClock::dateKey(date) >= today) return false;
+            e.finish();
+            if (finished != nullptr) finished->push_back(eventId);
+            return true;
+        });
+    }
+
+    // Ids of the events whose name contains name (case insensitive), in ascending order
+    vector<int> searchByName(const string& name) {
+        indexCatalog();
+        return nameIndex.search(name);
+    }
+
+    // The queries below return ids in date order as views into the date index,
+    // resolve them with getEvent(). A view is invalidated by the next add/edit/delete.
+    EventDateIndex::Range getEventsByCategory(Category category) {
+        indexCatalog();
+        return dateIndex.inCategory(category);
+    }
+
+    // e.g. Sports events between two dates (both included)
+    EventDateIndex::Range getEventsByCategory(Category category, const Date& from, const Date& to) {
+        indexCatalog();
+        return dateIndex.inCategory(category, from, to);
+    }
+
+    EventDateIndex::Range getEventsBetween(const Date& from, const Date& to) {
+        indexCatalog();
+        return dateIndex.between(from, to);
     }
 
-    vector<Event>& getEvents() { return events; }
-    const vector<Event>& getEvents() const { return events; }
+    // Live events only, tombstones are skipped
+    // Note: this loads every catalog event that was not requested yet
+    vector<Event*> getEvents() {
+        for (int i = 0; catalogPending > 0 && i < catalog.size(); ++i) {
+            if (!catalogLoaded[i])
+                loadFromCatalog(i);
+        }
 
-    const int getNEvents() const { return events.size(); }
+        vector<Event*> events;
+        events.reserve(idIndex.size());
+        for (Event& e : slots) {
+            if (e.getId() != 0)
+                events.push_back(&e);
+        }
+        return events;
+    }
+
+    // Events currently held in slots, catalog events that were not requested yet are not included
+    vector<const Event*> getEvents() const {
+        vector<const Event*> events;
+        events.reserve(idIndex.size());
+        for (const Event& e : slots) {
+            if (e.getId() != 0)
+                events.push_back(&e);
+        }
+        return events;
+    }
+
+    // Catalog events that were deleted (not just loaded into slots)
+    vector<int> getDeletedCatalogIds() const {
+        vector<int> ids;
+        for (int i = 0; i < catalog.size(); ++i) {
+            int id = catalog.getRecord(i).id;
+            if (catalogLoaded[i] && idIndex.find(id) == idIndex.end())
+                ids.push_back(id);
+        }
+        return ids;
+    }
+
+    const int getNEvents() const { return idIndex.size() + catalogPending; }
 
     Event* getEvent(int ID) {
-        auto it = find_if(events.begin(), events.end(),
-            [ID](Event& e) {
-                return e.getId() == ID;
-            }
-        );
-
-        if (it != events.end())
-            return &(*it);
+        auto it = idIndex.find(ID);
+        if (it != idIndex.end())
+            return &slots[it->second];
+
+        if (catalog.isOpen()) {
+            int index = catalog.find(ID);
+            if (index != -1 && !catalogLoaded[index])
+                return loadFromCatalog(index);
+        }
 
         return nullptr;
     }
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+// Case-insensitive substring search over event names
+// Names are case folded and split into words, every 3-letter window (trigram) of every word
+// points to the events containing it. A query only checks the events that contain all of its
+// trigrams instead of scanning every name.
+class EventSearchIndex {
+private:
+    // trigram (3 folded chars packed in an int) -> ids of events whose name contains it
+    unordered_map<uint32_t, unordered_set<int>> trigrams;
+    // id -> folded name, used to verify candidates and to unindex on remove/update
+    unordered_map<int, string> names;
+
+    static string fold(const string& s) {
+        string folded(s);
+        transform(folded.begin(), folded.end(), folded.begin(),
+            [](unsigned char c) { return (char)tolower(c); });
+        return folded;
+    }
+
+    static uint32_t pack(const string& s, size_t i) {
+        return ((uint32_t)(unsigned char)s[i] << 16) | ((uint32_t)(unsigned char)s[i + 1] << 8) | (unsigned char)s[i + 2];
+    }
+
+    // Trigrams of each word of an already folded text
+    static vector<uint32_t> trigramsOf(const string& folded) {
+        vector<uint32_t> grams;
+        size_t start = 0;
+        while (start < folded.size()) {
+            size_t end = folded.find(' ', start);
+            if (end == string::npos) end = folded.size();
+            for (size_t i = start; i + 3 <= end; ++i) {
+                grams.push_back(pack(folded, i));
+            }
+            start = end + 1;
+        }
+        sort(grams.begin(), grams.end());
+        grams.erase(unique(grams.begin(), grams.end()), grams.end());
+        return grams;
+    }
+
+public:
+    void add(int id, const string& name) {
+        string folded = fold(name);
+        for (uint32_t g : trigramsOf(folded)) {
+            trigrams[g].insert(id);
+        }
+        names[id] = folded;
+    }
+
+    void remove(int id) {
+        auto it = names.find(id);
+        if (it == names.end()) return;
+        for (uint32_t g : trigramsOf(it->second)) {
+            auto posting = trigrams.find(g);
+            if (posting == trigrams.end()) continue;
+            posting->second.erase(id);
+            if (posting->second.empty()) trigrams.erase(posting);
+        }
+        names.erase(it);
+    }
+
+    void update(int id, const string& name) {
+        remove(id);
+        add(id, name);
+    }
+
+    bool contains(int id) const { return names.count(id) != 0; }
+
+    // Ids (ascending) of the events whose name contains query, ignoring case
+    vector<int> search(const string& query) const {
+        string folded = fold(query);
+        vector<uint32_t> grams = trigramsOf(folded);
+        vector<int> matched;
+
+        // Queries made only of words shorter than 3 letters have no trigram to look up
+        if (grams.empty()) {
+            for (const auto& entry : names) {
+                if (entry.second.find(folded) != string::npos)
+                    matched.push_back(entry.first);
+            }
+            sort(matched.begin(), matched.end());
+            return matched;
+        }
+
+        // Walk the smallest posting list and keep the ids present in all the others
+        vector<const unordered_set<int>*> postings;
+        for (uint32_t g : grams) {
+            auto it = trigrams.find(g);
+            if (it == trigrams.end()) return matched;
+            postings.push_back(&it->second);
+        }
+        sort(postings.begin(), postings.end(),
+            [](const unordered_set<int>* a, const unordered_set<int>* b) { return a->size() < b->size(); });
+
+        for (int id : *postings[0]) {
+            bool inAll = true;
+            for (size_t i = 1; i < postings.size() && inAll; ++i) {
+                inAll = postings[i]->count(id) != 0;
+            }
+            // trigrams can all be present without the query being one contiguous substring
+            if (inAll && names.at(id).find(folded) != string::npos)
+                matched.push_back(id);
+        }
+        sort(matched.begin(), matched.end());
+        return matched;
+    }
+};
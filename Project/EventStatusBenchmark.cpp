@@ -0,0 +1,152 @@
+// Event status reads, the old per-call clock check against the tracked status
+// Adds --events events dated from --days days ago to --days days ahead, each with one booked ticket.
+// Reads every event's status --reads times, first the old way (time() + localtime + date compare per
+// call) then with Event::getEventStatus, and simulates --days days passing one
+// EventManager::advanceStatuses tick a day, the finished events' tickets expired by a background
+// TicketExpirySweeper. Exits non-zero if an event dated before the last simulated day is not Finished
+// with its ticket Expired, or a later one is not Upcoming with its ticket Reserved.
+//
+//   ticketak-status-bench [--events 1000000] [--days 365] [--reads 5]
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "EventManager.cpp"
+#include "TicketExpirySweeper.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// Event::getEventStatus before the status was tracked
+static EventStatus oldStatus(const Event& e) {
+    time_t t = time(nullptr);
+    tm today{};
+    localtime_r(&t, &today);
+    if (e.getYear() != today.tm_year + 1900) return e.getYear() < today.tm_year + 1900 ? EventStatus::Finished : EventStatus::Upcoming;
+    if (e.getMonth() != today.tm_mon + 1) return e.getMonth() < today.tm_mon + 1 ? EventStatus::Finished : EventStatus::Upcoming;
+    return e.getDay() < today.tm_mday ? EventStatus::Finished : EventStatus::Upcoming;
+}
+
+// today moved by offset days
+static Date dayFromToday(int offset) {
+    time_t t = time(nullptr);
+    tm day{};
+    localtime_r(&t, &day);
+    day.tm_mday += offset;
+    day.tm_hour = 12;
+    mktime(&day);
+    return Date{day.tm_mday, day.tm_mon + 1, day.tm_year + 1900};
+}
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const int nEvents = stoi(argValue(argc, argv, "--events", "1000000"));
+    const int nDays = stoi(argValue(argc, argv, "--days", "365"));
+    const int nReads = stoi(argValue(argc, argv, "--reads", "5"));
+
+    EventManager& manager = EventManager::getInstance();
+    EventClock::refresh();
+    vector<Date> dates;
+    for (int d = -nDays; d <= nDays; ++d) dates.push_back(dayFromToday(d));
+
+    auto start = chrono::steady_clock::now();
+    vector<Event> batch;
+    batch.reserve(nEvents);
+    for (int i = 0; i < nEvents; ++i) {
+        batch.emplace_back(0, "Event " + to_string(i + 1), Category::Sports, dates[i % dates.size()],
+                           TicketTypePriceQuantity{TicketType::VIP, Money(), 0},
+                           TicketTypePriceQuantity{TicketType::Economic, Money(), 0},
+                           TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), 1});
+    }
+    manager.addEvents(batch);
+    vector<uint64_t> tickets(nEvents);
+    for (int i = 0; i < nEvents; ++i)
+        tickets[i] = manager.getEvent(batch[i].getId())->bookEvent(1, TicketTypePrice{TicketType::Regular, Money::pounds(100)}).getId();
+    cout << nEvents << " events over " << dates.size() << " days, added in " << seconds(start) << " s" << endl;
+
+    // advanceStatuses only flips status fields, the id index the resolver reads is not written meanwhile
+    TicketExpirySweeper sweeper([&manager](int eventId) {
+        Event* e = manager.getEvent(eventId);
+        return e != nullptr ? e->getTicketIds() : vector<uint64_t>();
+    });
+
+    // the first tick finishes the events already past, then the sweeper expires their tickets
+    vector<int> finishedIds;
+    start = chrono::steady_clock::now();
+    size_t finished = manager.updateStatuses(&finishedIds);
+    double tickMs = seconds(start) * 1e3;
+    start = chrono::steady_clock::now();
+    sweeper.enqueue(finishedIds);
+    size_t expired = sweeper.sweep();
+    cout << "first tick: " << finished << " events finished in " << tickMs << " ms, " << expired
+         << " tickets expired in " << seconds(start) * 1e3 << " ms" << endl;
+
+    vector<Event*> events(nEvents);
+    for (int i = 0; i < nEvents; ++i) events[i] = manager.getEvent(batch[i].getId());
+    long long nOld = 0, nNew = 0;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < nReads; ++r)
+        for (Event* e : events) nOld += oldStatus(*e) == EventStatus::Finished;
+    double oldNanos = seconds(start) * 1e9 / ((double)nReads * nEvents);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < nReads; ++r)
+        for (Event* e : events) nNew += e->getEventStatus() == EventStatus::Finished;
+    double newNanos = seconds(start) * 1e9 / ((double)nReads * nEvents);
+
+    char line[160];
+    snprintf(line, sizeof(line), "status read: localtime %8.2f ns, tracked %6.2f ns (%.0fx)", oldNanos, newNanos,
+             oldNanos / newNanos);
+    cout << line << endl;
+    bool ok = nOld == nNew;
+
+    // one tick a day for nDays days, each finishes the events of one day
+    sweeper.start();
+    double tickSeconds = 0, worstTick = 0;
+    finished = 0;
+    for (int d = 1; d <= nDays; ++d) {
+        finishedIds.clear();
+        start = chrono::steady_clock::now();
+        finished += manager.advanceStatuses(EventClock::dateKey(dates[nDays + d]), &finishedIds);
+        double tick = seconds(start);
+        tickSeconds += tick;
+        if (tick > worstTick) worstTick = tick;
+        sweeper.enqueue(finishedIds);
+    }
+    sweeper.waitIdle();
+    ExpiryProgress progress = sweeper.progress();
+    snprintf(line, sizeof(line), "%d daily ticks: %zu events finished, %.1f us/tick (worst %.1f us), %.2f us/event",
+             nDays, finished, tickSeconds * 1e6 / nDays, worstTick * 1e6, tickSeconds * 1e6 / (finished ? finished : 1));
+    cout << line << endl;
+    snprintf(line, sizeof(line), "sweeper: %zu events queued, %zu swept, %zu tickets expired in %zu batches, %zu pending",
+             progress.eventsQueued, progress.eventsSwept, progress.ticketsExpired, progress.batches, progress.pending);
+    cout << line << endl;
+
+    int today = EventClock::today();
+    TicketStore& store = TicketStore::getInstance();
+    long long wrong = 0;
+    for (int i = 0; i < nEvents; ++i) {
+        const Event* e = events[i];
+        bool past = EventClock::dateKey(Date{e->getDay(), e->getMonth(), e->getYear()}) < today;
+        Ticket t;
+        bool stored = store.get(tickets[i], t);
+        if (!stored || e->getEventStatus() != (past ? EventStatus::Finished : EventStatus::Upcoming) ||
+            t.getTicketStatus() != (past ? TicketStatus::Expired : TicketStatus::Reserved))
+            wrong++;
+    }
+    ok = ok && wrong == 0;
+    cout << (ok ? "status checks passed" : "status checks FAILED: " + to_string(wrong) + " events") << endl;
+    return ok ? 0 : 1;
+}
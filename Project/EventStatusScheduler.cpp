@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "Event.cpp"
+
+using namespace std;
+
+// Upcoming -> Finished transitions worked out ahead of time: every event waits in a min-heap keyed
+// by its date, and a tick pops only the events whose date has passed since the last tick, so a
+// tick costs O(log n) per finished event and nothing for the rest.
+//
+// An event whose date is edited is scheduled again; the entry for its old date stays in the heap
+// and is dropped when popped (the finish callback checks the event's current date).
+// Not thread safe, EventManager's caller serializes calls.
+class EventStatusScheduler {
+public:
+    // Returns false for a stale entry (event deleted or re-dated)
+    using Finish = function<bool(int eventId)>;
+
+    void schedule(int eventId, const Date& date) {
+        heap.push(Entry{EventClock::dateKey(date), eventId});
+    }
+
+    // Finishes every event dated before today (a yyyymmdd key), returns how many
+    size_t advanceTo(int today, const Finish& finish) {
+        size_t finished = 0;
+        while (!heap.empty() && heap.top().date < today) {
+            int eventId = heap.top().eventId;
+            heap.pop();
+            if (finish(eventId)) finished++;
+        }
+        return finished;
+    }
+
+    // Events not finished yet, stale entries included
+    size_t size() const { return heap.size(); }
+
+private:
+    struct Entry {
+        int date;
+        int eventId;
+
+        bool operator>(const Entry& other) const {
+            return date != other.date ? date > other.date : eventId > other.eventId;
+        }
+    };
+
+    priority_queue<Entry, vector<Entry>, greater<Entry>> heap;
+};
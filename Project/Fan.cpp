@@ -1,16 +1,29 @@
 #pragma once
 
 #include "User.cpp"
-#include "Ticket.cpp"
+#include "TicketStore.cpp"
 #include <vector>
 #include <string>
 
 using namespace std;
 
+// A view of consecutive ticket ids owned by a Fan, valid until the fan buys another ticket
+struct TicketIdRange {
+    const uint64_t* first = nullptr;
+    const uint64_t* last = nullptr;
+
+    const uint64_t* begin() const { return first; }
+    const uint64_t* end() const { return last; }
+    size_t size() const { return (size_t)(last - first); }
+    bool empty() const { return first == last; }
+    uint64_t operator[](size_t i) const { return first[i]; }
+};
+
 class Fan : public User {
 private:
     int id = 0;
-    vector<Ticket> myTickets;
+    // ids of the fan's tickets in the TicketStore, in purchase order and only ever appended to
+    vector<uint64_t> myTickets;
 
 public:
     Fan() = default;
@@ -18,40 +31,87 @@ public:
     Fan(string name, string email, string password, char gender, string phone)
         : User(name,email,password,gender,phone), id(0) {}
 
-    void buyTicket(Ticket myTicket)
+    void buyTicket(const Ticket& myTicket)
     {
-        myTickets.push_back(myTicket);
+        myTickets.push_back(myTicket.getId());
     }
 
-    vector<Ticket> getMyTickets() const
+    void buyTicket(uint64_t ticketId)
+    {
+        myTickets.push_back(ticketId);
+    }
+
+    const vector<uint64_t>& getMyTicketIds() const
     {
         return myTickets;
     }
 
-    vector<string> buildTicketsMenuItems()
+    size_t getTicketCount() const { return myTickets.size(); }
+
+    bool hasTickets() const { return !myTickets.empty(); }
+
+    // Ids of tickets [from, from + count) clamped to the fan's tickets, no copy
+    TicketIdRange getMyTicketIds(size_t from, size_t count) const
+    {
+        from = min(from, myTickets.size());
+        count = min(count, myTickets.size() - from);
+        return TicketIdRange{myTickets.data() + from, myTickets.data() + from + count};
+    }
+
+    // One page of the fan's tickets read from the TicketStore, e.g. getMyTickets(100, 50) for the
+    // 101st to 150th; costs the page size whatever the fan owns
+    vector<Ticket> getMyTickets(size_t from, size_t count) const
+    {
+        TicketIdRange ids = getMyTicketIds(from, count);
+        vector<Ticket> tickets;
+        tickets.reserve(ids.size());
+        const TicketStore& store = TicketStore::getInstance();
+        Ticket t;
+        for (uint64_t ticketId : ids) {
+            if (store.get(ticketId, t)) tickets.push_back(t);
+        }
+        return tickets;
+    }
+
+    // All of the fan's tickets
+    vector<Ticket> getMyTickets() const
+    {
+        return getMyTickets(0, myTickets.size());
+    }
+
+    // Menu items of one page of tickets, numbered from 1 within the page
+    vector<string> buildTicketsMenuItems(size_t from, size_t count)
     {
         vector<string> ticketItems;
+        vector<Ticket> tickets = getMyTickets(from, count);
 
-        if (myTickets.empty()) {
+        if (tickets.empty()) {
             ticketItems.push_back("No tickets available.\n");
             return ticketItems;
         }
 
         auto& eventManager = EventManager::getInstance();
-        // Create a menu item for each ticket
-        for (size_t i = 0; i < myTickets.size(); i++) {
-            Ticket& currTicket = myTickets[i];
+        // a fan's tickets come in runs of the same event, look each event up once per run
+        int lastEventId = 0;
+        bool lastFinished = false;
+        for (size_t i = 0; i < tickets.size(); i++) {
+            Ticket& currTicket = tickets[i];
 
-            // Update Ticket Status if Needed
+            // Shown expired as soon as the event finishes, the sweeper updates the store shortly after
             if (currTicket.getTicketStatus() != TicketStatus::Expired){
-                Event* e = eventManager.getEvent(currTicket.getEventId());
-                if (e && e->getEventStatus() == EventStatus::Finished) { e->expireTickets(); }   
+                if (currTicket.getEventId() != lastEventId) {
+                    lastEventId = currTicket.getEventId();
+                    Event* e = eventManager.getEvent(lastEventId);
+                    lastFinished = e && e->getEventStatus() == EventStatus::Finished;
+                }
+                if (lastFinished)
+                    currTicket.setTicketStatus(TicketStatus::Expired);
             }
 
             string item =
-                to_string(i + 1) + "- Ticket ID: " + currTicket.getId() +
+                to_string(i + 1) + "- Ticket ID: " + currTicket.getIdStr() +
                 " | Type: " + currTicket.getType() +
-                " | Price: " + to_string(currTicket.getPrice()) +
+                " | Price: " + currTicket.getPrice().toString() +
                 " | Status: " + currTicket.getTicketStatusStr() +
                 "\n";
 
@@ -63,16 +123,17 @@ public:
 
     string getTicketDetails(int index)
     {
-        if (index < 0 || index >= (int)myTickets.size()) {
+        Ticket t;
+        if (index < 0 || index >= (int)myTickets.size() || !TicketStore::getInstance().get(myTickets[index], t)) {
             return "Invalid ticket index.";
         }
 
-        Ticket& t = myTickets[index];
         string details = "========== Ticket Details ==========\n";
-        details += "Ticket ID: " + t.getId() + "\n";
+        details += "Ticket ID: " + t.getIdStr() + "\n";
         details += "Event ID: " + to_string(t.getEventId()) + "\n";
         details += "Type: " + t.getType() + "\n";
-        details += "Price: " + to_string(t.getPrice()) + " EGP\n";
+        details += "Price: " + t.getPrice().toString() + " EGP\n";
+        details += "Seat: " + t.getSeatStr() + "\n";
         details += "Status: " + t.getTicketStatusStr() + "\n";
         details += "===================================\n";
 
@@ -2,12 +2,20 @@
 
 #include "Fan.cpp"
 #include <string>
-#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 // Singleton Class for Fans
 class FanManager {
 private:
-    vector<Fan> fans;
+    // deque never moves its elements on push_back, so Fan* handed out
+    // (e.g. SystemManager::currentFan) stay valid while fans are added
+    deque<Fan> fans;
+
+    // Secondary indexes: email -> slot and id -> slot in fans
+    unordered_map<string, size_t> emailIndex;
+    unordered_map<int, size_t> idIndex;
 
     // Private constructor
     FanManager() = default;
@@ -27,49 +35,55 @@ public:
     }
 
     void addFan(const Fan& fan) {
+        size_t slot = fans.size();
         fans.push_back(fan);
+        emailIndex[fan.getEmail()] = slot;
+        idIndex[fan.getId()] = slot;
     }
 
-    const vector<Fan>& getFans() const {
-        return fans;
+    // Bulk insert: the indexes are grown once for the whole batch
+    // Fans whose email is already registered (or repeated in the batch) are skipped,
+    // the others get ids continuing from getSize() like a normal registration.
+    // Returns the number of fans added.
+    size_t addFans(vector<Fan>& batch) {
+        emailIndex.reserve(emailIndex.size() + batch.size());
+        idIndex.reserve(idIndex.size() + batch.size());
+
+        size_t added = 0;
+        for (Fan& fan : batch) {
+            if (emailIndex.count(fan.getEmail())) continue;
+            fan.setId(getSize());
+            addFan(fan);
+            ++added;
+        }
+        return added;
     }
 
-    Fan* getFanByEmail(string email) {
-        auto it = find_if(fans.begin(), fans.end(),
-            [email](Fan& f) {
-                return (f.getEmail() == email);
-            }
-        );
+    const deque<Fan>& getFans() const {
+        return fans;
+    }
 
-        if (it != fans.end())
-            return &(*it);
+    Fan* getFanByEmail(const string& email) {
+        auto it = emailIndex.find(email);
+        if (it != emailIndex.end())
+            return &fans[it->second];
 
         return nullptr;
     }
 
-    Fan* getFanByEmailPass(string email, string password) {
-        auto it = find_if(fans.begin(), fans.end(),
-            [email, password](Fan& f) {
-                return (f.getEmail() == email && f.getPassword() == password);
-            }
-        );
-
-        if (it != fans.end())
-            return &(*it);
+    Fan* getFanByEmailPass(const string& email, const string& password) {
+        Fan* fan = getFanByEmail(email);
+        if (fan != nullptr && fan->getPassword() == password)
+            return fan;
 
         return nullptr;
     }
 
     Fan* getFan(int ID) {
-        auto it = find_if(fans.begin(), fans.end(),
-            [ID](Fan& f) {
-                return f.getId() == ID;
-            }
-        );
-
-        if (it != fans.end())
-            return &(*it);
+        auto it = idIndex.find(ID);
+        if (it != idIndex.end())
+            return &fans[it->second];
 
         return nullptr;
     }
-};
\ No newline at end of file
+};
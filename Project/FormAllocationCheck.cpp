@@ -0,0 +1,122 @@
+// Heap use of the form engine, counted by replacing the global operator new and delete
+// Opens the add event form --opens times on the process's own PosixTerminal, its keys written into
+// a pipe standing in for stdin and the screen going to /dev/null. Every open types the whole event
+// and presses Enter; the second round also makes --edits runs of six editing keys (type, Backspace,
+// Left, Right, Home, End) in the last field first. Exits non-zero if an open allocates anything
+// after the first (neither drawing nor a key press may) or if memory is still held after the forms
+// closed (a form must not leak).
+//
+//   ticketak-form-alloc-check [--opens 200] [--edits 100]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "GenericMultiEditorForm.cpp"
+#include "EventForm.cpp"
+
+using namespace std;
+
+static atomic<size_t> allocations{0};
+static atomic<size_t> frees{0};
+
+void* operator new(size_t n) {
+    allocations++;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    frees++;
+    free(p);
+}
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// Keys that fill the add event form (Down to the next field), editRuns runs of edits in the last
+// one that leave its text as it was, then Enter
+static string formKeys(int editRuns) {
+    const vector<string> typed = {"Cairo Derby", "12", "7", "2099", "850.50", "100", "300", "2000", "99.9", "5000"};
+    string keys;
+    for (size_t i = 0; i < typed.size(); ++i) {
+        keys += typed[i];
+        if (i + 1 < typed.size()) keys += "\x1b[B";
+    }
+    for (int e = 0; e < editRuns; ++e) keys += "7\x7f\x1b[D\x1b[C\x1b[H\x1b[F";
+    return keys + "\r";
+}
+
+// One form open with keys waiting in the pipe, returns the allocations it made
+static size_t openForm(Event& event, int pipeIn, const string& keys, bool& filled) {
+    if (write(pipeIn, keys.data(), keys.size()) != (ssize_t)keys.size()) {
+        filled = false;
+        return 0;
+    }
+    size_t before = allocations;
+    filled = showForm(event, EVENT_FORM) && filled;
+    return allocations - before;
+}
+
+int main(int argc, char* argv[]) {
+    const int nOpens = stoi(argValue(argc, argv, "--opens", "200"));
+    const int nEdits = stoi(argValue(argc, argv, "--edits", "100"));
+    // each open's keys have to fit in the pipe before the form reads them
+    const string plainKeys = formKeys(0), editKeys = formKeys(nEdits);
+    if (editKeys.size() > 60000) {
+        cout << "--edits too large for one pipe write" << endl;
+        return 1;
+    }
+
+    // stdin is the pipe and stdout /dev/null before the terminal is first used
+    int keysFds[2];
+    if (pipe(keysFds) != 0) return 1;
+    int devNull = open("/dev/null", O_WRONLY);
+    if (devNull < 0) return 1;
+    int savedOut = dup(STDOUT_FILENO);
+    dup2(keysFds[0], STDIN_FILENO);
+    dup2(devNull, STDOUT_FILENO);
+
+    Event event;
+    bool filled = true;
+    // first open: the terminal and anything else created once
+    openForm(event, keysFds[1], plainKeys, filled);
+    size_t liveBefore = allocations - frees;
+
+    size_t plainAllocs = 0, editAllocs = 0;
+    for (int i = 0; i < nOpens; ++i) plainAllocs += openForm(event, keysFds[1], plainKeys, filled);
+    for (int i = 0; i < nOpens; ++i) editAllocs += openForm(event, keysFds[1], editKeys, filled);
+    size_t liveAfter = allocations - frees;
+
+    Terminal::getInstance().flush();
+    dup2(savedOut, STDOUT_FILENO);
+    filled = filled && event.getName() == "Cairo Derby" && event.getCapacity() == 7100;
+
+    const size_t editKeyCount = (size_t)nOpens * nEdits * 6;
+    char line[160];
+    snprintf(line, sizeof(line), "form opens: %d, allocations per open %.2f", 2 * nOpens,
+             (double)(plainAllocs + editAllocs) / (2 * nOpens));
+    cout << line << endl;
+    snprintf(line, sizeof(line), "editing keys: %zu, allocations %zu", editKeyCount,
+             editAllocs > plainAllocs ? editAllocs - plainAllocs : (size_t)0);
+    cout << line << endl;
+    snprintf(line, sizeof(line), "blocks held after the forms closed: %zd", (ssize_t)(liveAfter - liveBefore));
+    cout << line << endl;
+
+    bool ok = filled && plainAllocs == 0 && editAllocs == 0 && liveAfter == liveBefore;
+    cout << (ok ? "form allocation checks passed" : "form allocation checks FAILED") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+// Filling an Event from the add event form, void* setters against the typed FormSchema
+// The old way is a vector of fields holding function<void(void*, const char*)> setters that cast the
+// object and convert with atoi/atof; the schema calls Event's setters directly with values parsed by
+// FormValue. Times --fills fills both ways, then exits non-zero if the schema accepts or rejects any
+// of the sampled inputs wrongly (atoi read "12x" as 12 and "" as 0, the schema refuses both).
+//
+//   ticketak-form-bench [--fills 1000000]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "EventForm.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// The Field the form engine used to take
+struct OldField {
+    string label;
+    int len;
+    string allowed;
+    function<void(void*, const char*)> setter;
+};
+
+static vector<OldField> oldEventFields() {
+    return {
+        {"Event Name:", 30, "A-Za-z ", [](void* obj, const char* v) { static_cast<Event*>(obj)->setName(v); }},
+        {"Day:", 2, "0-9", [](void* obj, const char* v) { static_cast<Event*>(obj)->setDay(atoi(v)); }},
+        {"Month:", 2, "0-9", [](void* obj, const char* v) { static_cast<Event*>(obj)->setMonth(atoi(v)); }},
+        {"Year:", 4, "0-9", [](void* obj, const char* v) { static_cast<Event*>(obj)->setYear(atoi(v)); }},
+        {"VIP Ticket Price:", 7, "0-9.", [](void* obj, const char* v) {
+            static_cast<Event*>(obj)->setTicketPrice(TicketType::VIP, Money::fromDouble(atof(v))); }},
+        {"VIP Ticket Quantity:", 6, "0-9", [](void* obj, const char* v) {
+            static_cast<Event*>(obj)->setTicketQuantity(TicketType::VIP, atoi(v)); }},
+        {"Regular Ticket Price:", 7, "0-9.", [](void* obj, const char* v) {
+            static_cast<Event*>(obj)->setTicketPrice(TicketType::Regular, Money::fromDouble(atof(v))); }},
+        {"Regular Ticket Quantity:", 6, "0-9", [](void* obj, const char* v) {
+            static_cast<Event*>(obj)->setTicketQuantity(TicketType::Regular, atoi(v)); }},
+        {"Economic Ticket Price:", 7, "0-9.", [](void* obj, const char* v) {
+            static_cast<Event*>(obj)->setTicketPrice(TicketType::Economic, Money::fromDouble(atof(v))); }},
+        {"Economic Ticket Quantity:", 6, "0-9", [](void* obj, const char* v) {
+            static_cast<Event*>(obj)->setTicketQuantity(TicketType::Economic, atoi(v)); }},
+    };
+}
+
+static const vector<string> typed = {"Cairo Derby", "12", "7", "2099", "850.50", "100", "300", "2000", "99.9", "5000"};
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const int nFills = stoi(argValue(argc, argv, "--fills", "1000000"));
+
+    // the typed text as the editor leaves it
+    FormLine lines[EVENT_FORM.SIZE];
+    EVENT_FORM.initLines(lines, nullptr);
+    for (int i = 0; i < EVENT_FORM.SIZE; ++i) lines[i].setText(typed[i]);
+
+    vector<OldField> oldFields = oldEventFields();
+    Event oldEvent;
+    auto start = chrono::steady_clock::now();
+    for (int f = 0; f < nFills; ++f) {
+        for (size_t i = 0; i < oldFields.size(); ++i) oldFields[i].setter(&oldEvent, lines[i].text);
+    }
+    double oldNanos = seconds(start) * 1e9 / nFills;
+
+    Event event;
+    int invalid = -1;
+    start = chrono::steady_clock::now();
+    for (int f = 0; f < nFills; ++f) invalid = max(invalid, EVENT_FORM.assign(event, lines));
+    double newNanos = seconds(start) * 1e9 / nFills;
+
+    char line[160];
+    snprintf(line, sizeof(line), "void* setters, atoi/atof: %8.1f ns/fill", oldNanos);
+    cout << line << endl;
+    snprintf(line, sizeof(line), "FormSchema, typed parse:  %8.1f ns/fill, %.1fx", newNanos, oldNanos / newNanos);
+    cout << line << endl;
+
+    bool ok = invalid == -1 && event.getName() == "Cairo Derby" && event.getYear() == 2099 &&
+              event.getTierPrice<TicketType::VIP>() == Money::fromPiastres(85050) &&
+              event.getTierPrice<TicketType::Economic>() == Money::fromPiastres(9990) &&
+              event.getTierQuantity<TicketType::Regular>() == 2000 && event.getCapacity() == 7100;
+
+    // one bad field at a time: the schema reports that field and no other
+    const vector<pair<int, string>> bad = {{1, ""}, {1, "1x"}, {3, "20x9"}, {4, "1.234"}, {4, "."},
+                                           {5, "-3"}, {8, "9..9"}, {9, ""}};
+    for (const auto& [index, text] : bad) {
+        FormLine copy[EVENT_FORM.SIZE];
+        for (int i = 0; i < EVENT_FORM.SIZE; ++i) copy[i] = lines[i];
+        copy[index].setText(text);
+        Event target;
+        int got = EVENT_FORM.assign(target, copy);
+        if (got != index) {
+            cout << "\"" << text << "\" in " << EVENT_FORM.label(index) << ": got " << got << endl;
+            ok = false;
+        }
+    }
+
+    // ints past INT_MAX are refused, not wrapped
+    static constexpr auto idForm = makeForm<int>(valueField<int>("Event ID:", 10, "0-9"));
+    FormLine idLine[1];
+    idForm.initLines(idLine, nullptr);
+    int id = 0;
+    idLine[0].setText("2147483647");
+    ok = ok && idForm.assign(id, idLine) == -1 && id == 2147483647;
+    idLine[0].setText("2147483648");
+    ok = ok && idForm.assign(id, idLine) == 0;
+
+    // prefill writes back what was parsed
+    FormLine round[EVENT_FORM.SIZE];
+    EVENT_FORM.initLines(round, &event);
+    const vector<string> expected = {"Cairo Derby", "12", "7", "2099", "850.50", "100", "300.00", "2000", "99.90", "5000"};
+    for (int i = 0; i < EVENT_FORM.SIZE; ++i) {
+        if (expected[i] != round[i].text) {
+            cout << EVENT_FORM.label(i) << " prefilled as \"" << round[i].text << "\"" << endl;
+            ok = false;
+        }
+    }
+
+    cout << (ok ? "form parsing checks passed" : "form parsing checks FAILED") << endl;
+    return ok ? 0 : 1;
+}
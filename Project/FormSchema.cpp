@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Money.cpp"
+
+using namespace std;
+
+// Longest input a form field takes, the editor keeps every line in a fixed buffer of this size
+constexpr int MAX_FIELD_LEN = 50;
+
+// One input line of a form while it is edited: where it is drawn, the characters it accepts, its
+// text (length chars, at most len) and the cursor's offset in it
+struct FormLine {
+    int x = 0;
+    int y = 0;
+    int len = 0;
+    const char* allowed = "";
+    char text[MAX_FIELD_LEN + 1] = {};
+    int length = 0;
+    int cursor = 0;
+
+    void setText(const string& value) {
+        length = (int)min(value.size(), (size_t)len);
+        memcpy(text, value.data(), (size_t)length);
+        text[length] = '\0';
+    }
+};
+
+// Typed value of a field: parse() reads the field's text (false if it is not a valid V), format()
+// writes a value back for a form opened on an existing object
+template <typename V>
+struct FormValue;
+
+template <>
+struct FormValue<string> {
+    static bool parse(const char* text, string& value) { value = text; return true; }
+    static string format(const string& value) { return value; }
+};
+
+template <>
+struct FormValue<int> {
+    // digits only, up to INT_MAX
+    static bool parse(const char* text, int& value) {
+        if (*text == '\0') return false;
+        long long n = 0;
+        for (; *text; ++text) {
+            if (*text < '0' || *text > '9') return false;
+            n = n * 10 + (*text - '0');
+            if (n > INT_MAX) return false;
+        }
+        value = (int)n;
+        return true;
+    }
+    static string format(int value) { return to_string(value); }
+};
+
+template <>
+struct FormValue<char> {
+    // a single character, upper cased
+    static bool parse(const char* text, char& value) {
+        if (text[0] == '\0' || text[1] != '\0') return false;
+        value = (char)toupper((unsigned char)text[0]);
+        return true;
+    }
+    static string format(char value) { return value ? string(1, value) : string(); }
+};
+
+template <>
+struct FormValue<Money> {
+    static bool parse(const char* text, Money& value) { return Money::parse(text, value); }
+    static string format(Money value) { return value.toString(); }
+};
+
+// A field bound to a setter of T, and to its getter when the form is opened on an existing object
+template <typename T, typename Arg, typename R>
+struct SetterField {
+    using Value = decay_t<Arg>;
+    const char* label;
+    int len;
+    const char* allowed;
+    void (T::*set)(Arg);
+    R (T::*get)() const;
+
+    bool assign(T& object, const char* text) const {
+        Value value;
+        if (!FormValue<Value>::parse(text, value)) return false;
+        (object.*set)(value);
+        return true;
+    }
+
+    string current(const T& object) const { return get ? FormValue<Value>::format((object.*get)()) : string(); }
+};
+
+// A field bound to a data member of T
+template <typename T, typename V>
+struct MemberField {
+    const char* label;
+    int len;
+    const char* allowed;
+    V T::*member;
+
+    bool assign(T& object, const char* text) const { return FormValue<V>::parse(text, object.*member); }
+    string current(const T& object) const { return FormValue<V>::format(object.*member); }
+};
+
+// A form of one field that fills a lone value, e.g. the event id to search for
+template <typename V>
+struct ValueField {
+    const char* label;
+    int len;
+    const char* allowed;
+
+    bool assign(V& value, const char* text) const { return FormValue<V>::parse(text, value); }
+    string current(const V& value) const { return FormValue<V>::format(value); }
+};
+
+template <typename T, typename Arg, typename R>
+constexpr SetterField<T, Arg, R> field(const char* label, int len, const char* allowed, void (T::*set)(Arg),
+                                       R (T::*get)() const) {
+    return SetterField<T, Arg, R>{label, len, allowed, set, get};
+}
+
+template <typename T, typename Arg>
+constexpr SetterField<T, Arg, decay_t<Arg>> field(const char* label, int len, const char* allowed, void (T::*set)(Arg)) {
+    return SetterField<T, Arg, decay_t<Arg>>{label, len, allowed, set, nullptr};
+}
+
+template <typename T, typename V, typename = enable_if_t<!is_function<V>::value>>
+constexpr MemberField<T, V> field(const char* label, int len, const char* allowed, V T::*member) {
+    return MemberField<T, V>{label, len, allowed, member};
+}
+
+template <typename V>
+constexpr ValueField<V> valueField(const char* label, int len, const char* allowed) {
+    return ValueField<V>{label, len, allowed};
+}
+
+// The fields of a form over a T, in screen order. Built as a constexpr from field() descriptors,
+// so filling the object is a direct call per field chosen at compile time, no type erasure:
+//
+//   static constexpr auto form = makeForm<LoginDTO>(field("Email:", 50, "A-Za-z0-9@.", &LoginDTO::email), ...);
+//   static_assert(form.isValid(), "field too long");
+template <typename T, typename... Fields>
+struct FormSchema {
+    static constexpr int SIZE = (int)sizeof...(Fields);
+    tuple<Fields...> fields;
+
+    // every field fits the editor's buffers
+    constexpr bool isValid() const { return isValid(index_sequence_for<Fields...>()); }
+
+    // Labels and limits into lines, with the object's current values when prefill is given
+    void initLines(FormLine* lines, const T* prefill) const { initLines(lines, prefill, index_sequence_for<Fields...>()); }
+
+    const char* label(int index) const { return labelAt(index, index_sequence_for<Fields...>()); }
+
+    // Sets every field that parses, returns the index of the first one that does not or -1
+    int assign(T& object, const FormLine* lines) const { return assign(object, lines, index_sequence_for<Fields...>()); }
+
+private:
+    template <size_t... I>
+    constexpr bool isValid(index_sequence<I...>) const {
+        return ((get<I>(fields).len > 0 && get<I>(fields).len <= MAX_FIELD_LEN) && ...);
+    }
+
+    template <size_t... I>
+    void initLines(FormLine* lines, const T* prefill, index_sequence<I...>) const {
+        ((lines[I].len = get<I>(fields).len, lines[I].allowed = get<I>(fields).allowed,
+          lines[I].setText(prefill ? get<I>(fields).current(*prefill) : string())), ...);
+    }
+
+    template <size_t... I>
+    const char* labelAt(int index, index_sequence<I...>) const {
+        const char* labels[] = {get<I>(fields).label...};
+        return labels[index];
+    }
+
+    template <size_t... I>
+    int assign(T& object, const FormLine* lines, index_sequence<I...>) const {
+        const bool parsed[] = {get<I>(fields).assign(object, lines[I].text)...};
+        for (int i = 0; i < SIZE; ++i) {
+            if (!parsed[i]) return i;
+        }
+        return -1;
+    }
+};
+
+template <typename T, typename... Fields>
+constexpr FormSchema<T, Fields...> makeForm(Fields... fields) {
+    return FormSchema<T, Fields...>{tuple<Fields...>(fields...)};
+}
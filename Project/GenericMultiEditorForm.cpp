@@ -4,182 +4,170 @@
 #include <string>
 #include <cstdio>
 #include <cstring>
-#include <windows.h>
-#include <conio.h>
 #include <cstdlib>
+#include <chrono>
+#include <thread>
 #include <functional>
 #include <vector>
 
-using namespace std;
-
-struct Field {
-    string label;
-    int len;
-    string regexStr;
-    // void* is a Pointer to Something we don't know what its type yet
-    // we will cast it to specific type when we use it inside
-    // function<> allows you to store a function in a variable like PHP
-    function<void(void*, const char*)> setter;
+#include "Terminal.cpp"
+#include "VirtualMenu.cpp"
+#include "FormSchema.cpp"
 
-    string oldValue = "";
-};
+using namespace std;
 
 void gotoxy(int x,int y);
 void textattr(int i);
-bool showForm(void* object, vector<Field>& fields, string errorMessage = "", int errorCount = 0, const int inputX = 18);
-void display(int nChar, char* arr, int cursor, int xPos, int yPos, int len);
-bool isCharAllowed(char ch, const string& regexStr);
-char** multiLineEditor(int* xPos, int* yPos, int* len, char** str, string* regexStrs, int N, int errorCount);
+void clearScreen();
+void pauseMs(int ms);
+void display(const FormLine& line);
+bool isCharAllowed(char ch, const char* allowed);
+bool multiLineEditor(FormLine* lines, int N, int errorCount);
 //int displayMenu(const vector<string>& menu, const string& MenuTitle = "=======Menu======");
 int displayMenu(const vector<string>& menu, const string& MenuTitle="=======Menu======", const string& MenuDescriptionTitle="",  const string& MenuDescription="",int YPositionOfESC = 3);
-
-// Generic Form to fill an Object
-bool showForm(void* object, vector<Field>& fields, string errorMessage, int errorCount, const int inputX) {
-    int n = fields.size();
+// Same over nItems entries whose text itemText(index) gives when the entry scrolls into view
+int displayMenu(size_t nItems, const function<string(size_t)>& itemText, const string& MenuTitle="=======Menu======", const string& MenuDescriptionTitle="",  const string& MenuDescription="",int YPositionOfESC = 3);
+
+// Generic Form to fill an Object, its fields described by a FormSchema (FormSchema.cpp)
+// prefill shows the object's current values in the fields, for editing or after a failed validation.
+// A field whose text does not parse as its type is reported and the form shown again.
+// The lines live on the stack, sized by the schema, and editing writes into the terminal's frame
+// buffer, so a form allocates nothing per key press and nothing outlives it.
+template <typename T, typename... Fields>
+bool showForm(T& object, const FormSchema<T, Fields...>& form, string errorMessage = "", int errorCount = 0,
+              const int inputX = 18, bool prefill = false) {
+    constexpr int n = FormSchema<T, Fields...>::SIZE;
     const int labelX = 2;
     //const int inputX = 21;
     const int startY = 1;
 
-    int* xPos = new int[n];
-    int* yPos = new int[n];
-    int* len  = new int[n];
-    char** oldValues = new char*[n];
-    string* regexStrs = new string[n];
-
-    system("cls");
-
+    FormLine lines[n];
+    form.initLines(lines, prefill ? &object : nullptr);
     for (int i = 0; i < n; ++i) {
-        int y = startY + i * 2;
-
-        gotoxy(labelX, y);
-        cout << fields[i].label;
-
-        xPos[i] = inputX;
-        yPos[i] = y;
-        len[i]  = fields[i].len;
-        oldValues[i] = new char[len[i] + 1];
-        regexStrs[i] = fields[i].regexStr;
-        // Writes len[i] (+1 for null-terminator char) characters from fields[i].oldvalue if exist
-        // to oldValues[i] using "%s" format (which means as string)
-        int len = fields[i].oldValue.size();
-        if (fields[i].len < len) len = fields[i].len;
-        snprintf(oldValues[i], len+1, "%.*s", len, fields[i].oldValue.c_str());
+        lines[i].x = inputX;
+        lines[i].y = startY + i * 2;
     }
 
-    if (!errorMessage.empty()) {
-        gotoxy(0, yPos[n-1] + 2);
-        cout << "\x1b[31m" << errorMessage << "\x1b[0m\n";
-        gotoxy(xPos[0], yPos[0]);
-    }
+    Terminal& term = Terminal::getInstance();
+    while (true) {
+        term.clear();
+        for (int i = 0; i < n; ++i) {
+            gotoxy(labelX, lines[i].y);
+            term.write(form.label(i));
+        }
 
-    char** values = multiLineEditor(xPos, yPos, len, oldValues, regexStrs, n,errorCount);
-    if (values == nullptr) return false;
+        if (!errorMessage.empty()) {
+            gotoxy(0, lines[n-1].y + 2);
+            term.write("\x1b[31m");
+            term.write(errorMessage);
+            term.write("\x1b[0m\n");
+            gotoxy(lines[0].x, lines[0].y);
+        }
 
-    for (int i = 0; i < n; ++i) {
-        fields[i].setter(object, values[i]);
+        if (!multiLineEditor(lines, n, errorCount)) return false;
+
+        int invalid = form.assign(object, lines);
+        if (invalid < 0) return true;
+        // "Day:" -> "Day is not valid.", the typed text stays in the fields
+        string label = form.label(invalid);
+        if (!label.empty() && label.back() == ':') label.pop_back();
+        errorMessage = "\n" + label + " is not valid.";
+        errorCount = 1;
     }
-    return true;
 }
 
 void gotoxy(int x,int y)
 {
-    COORD coord={0,0};
-    coord.X=x;
-    coord.Y=y;
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE),coord);
+    Terminal::getInstance().moveTo(x, y);
 }
 
 void textattr(int i)
 {
-	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), i);
+    Terminal::getInstance().setAttr(i);
 }
 
-char** multiLineEditor(int* xPos, int* yPos, int* len, char** str, string* regexStrs, int N, int errorCount){
-    int index = 0;
+// Clears the screen at once (no shell is started for it)
+void clearScreen()
+{
+    Terminal& term = Terminal::getInstance();
+    term.clear();
+    term.flush();
+}
 
-    //char** str = new char*[N];
-    char** current = new char*[N];
-    char** first = new char*[N];
-    char** last = new char*[N];
-    int* cursor = new int[N]{};
+// Shows what was printed so far, then waits
+void pauseMs(int ms)
+{
+    Terminal::getInstance().flush();
+    this_thread::sleep_for(chrono::milliseconds(ms));
+}
+
+bool multiLineEditor(FormLine* lines, int N, int errorCount){
+    int index = 0;
 
     for(int i = 0; i < N; ++i){
-        current[i] = first[i] = str[i];
-        last[i] = str[i] + (strlen(str[i]));
-        display((int)strlen(str[i]), str[i], cursor[i], xPos[i], yPos[i], len[i]);
+        display(lines[i]);
     }
 
-    gotoxy(0, yPos[N-1] + errorCount + 3);
-    cout << "Press ESC to back.";
-    gotoxy(xPos[0], yPos[0]);
+    Terminal& term = Terminal::getInstance();
+    gotoxy(0, lines[N-1].y + errorCount + 3);
+    term.write("Press ESC to back.");
+    gotoxy(lines[0].x, lines[0].y);
     while(true){
-        char ch = getch();
+        FormLine& line = lines[index];
+        int ch = term.readKey();
         switch(ch){
-        case -32:{
-            ch = getch();
-            switch(ch){
-            case 77: // Right Arrow
-                if (current[index] < last[index]){
-                    gotoxy(++cursor[index] + xPos[index], yPos[index]);
-                    ++current[index];
-                }
-                break;
-            case 75: // Left Arrow
-                if (current[index] > first[index])
-                {
-                    gotoxy(--cursor[index] + xPos[index], yPos[index]);
-                    --current[index];
-                }
-                break;
-            case 80: // Down Arrow
-                if (index < N - 1){
-                    index++;
-                    gotoxy(cursor[index] + xPos[index], yPos[index]);
-                }
-                break;
-            case 72: // Up Arrow
-                if (index > 0){
-                    index--;
-                    gotoxy(cursor[index] + xPos[index], yPos[index]);
-                }
-                break;
-            case 71: // Home Key
-                cursor[index] = 0;
-                gotoxy(cursor[index] + xPos[index], yPos[index]);
-                current[index] = first[index];
-                break;
-            case 79: // End Key
-                cursor[index] = last[index] - first[index];
-                gotoxy(cursor[index] + xPos[index], yPos[index]);
-                current[index] = last[index];
-                break;
-            case 83: // Delete
-                // AB|CD
-                // AB|D
-                if(current[index] < last[index]){
-                    memmove(current[index], current[index] + 1, last[index] - current[index] - 1);
-                    last[index]--;
-                }
-                display((last[index] - first[index]), str[index], cursor[index], xPos[index], yPos[index], len[index]);
-                break;
+        case KeyRight: // Right Arrow
+            if (line.cursor < line.length){
+                gotoxy(++line.cursor + line.x, line.y);
             }
             break;
-        }
+        case KeyLeft: // Left Arrow
+            if (line.cursor > 0)
+            {
+                gotoxy(--line.cursor + line.x, line.y);
+            }
+            break;
+        case KeyDown: // Down Arrow
+            if (index < N - 1){
+                index++;
+                gotoxy(lines[index].cursor + lines[index].x, lines[index].y);
+            }
+            break;
+        case KeyUp: // Up Arrow
+            if (index > 0){
+                index--;
+                gotoxy(lines[index].cursor + lines[index].x, lines[index].y);
+            }
+            break;
+        case KeyHome: // Home Key
+            line.cursor = 0;
+            gotoxy(line.x, line.y);
+            break;
+        case KeyEnd: // End Key
+            line.cursor = line.length;
+            gotoxy(line.cursor + line.x, line.y);
+            break;
+        case KeyDelete: // Delete
+            // AB|CD
+            // AB|D
+            if(line.cursor < line.length){
+                memmove(line.text + line.cursor, line.text + line.cursor + 1, line.length - line.cursor - 1);
+                line.length--;
+            }
+            display(line);
+            break;
         case 27: // Esc Key
-            system("cls");
-            return nullptr;
+            clearScreen();
+            return false;
         case 8: // Backspace
         {
             // AB|CD
             // A|CD
-            if(current[index] > first[index]){
-                if(current[index] != last[index]){
-                    memmove(current[index] - 1, current[index], last[index] - current[index]);
-                }
-                --cursor[index];
-                --current[index];
-                --last[index];
-                display((last[index] - first[index]), str[index], cursor[index], xPos[index], yPos[index], len[index]);
+            if(line.cursor > 0){
+                memmove(line.text + line.cursor - 1, line.text + line.cursor, line.length - line.cursor);
+                --line.cursor;
+                --line.length;
+                display(line);
             }
             break;
         }
@@ -189,128 +177,114 @@ char** multiLineEditor(int* xPos, int* yPos, int* len, char** str, string* regex
             } else if (index < N - 1){
                 ++index;
             }
-            gotoxy(cursor[index] + xPos[index], yPos[index]);
+            gotoxy(lines[index].cursor + lines[index].x, lines[index].y);
             break;
         case '\r': { // Enter
             for(int i = 0; i < N; ++i){
-                *last[i] = '\0';
+                lines[i].text[lines[i].length] = '\0';
             }
-            return str;
+            return true;
         }
         default:
-            if((last[index] == &str[index][len[index]]) || !isCharAllowed(ch, regexStrs[index])){
+            if(ch > 0xFF || line.length == line.len || !isCharAllowed((char)ch, line.allowed)){
                 break;
             }
 
-            if (current[index] < last[index]) {
+            if (line.cursor < line.length) {
                 // AB|CB
                 // ABD|CB
-                memmove(current[index] + 1, current[index], last[index] - current[index]);
+                memmove(line.text + line.cursor + 1, line.text + line.cursor, line.length - line.cursor);
             }
             // Else
             // AB|
             // ABC|
-            *current[index] = ch;
-            ++cursor[index];
-            // advance the pointers
-            ++current[index];
-            ++last[index];
+            line.text[line.cursor] = (char)ch;
+            ++line.cursor;
+            ++line.length;
 
-            display((last[index] - first[index]), str[index], cursor[index], xPos[index], yPos[index], len[index]);
+            display(line);
         }
     }
-
-
-    return str;
 }
 
-bool isCharAllowed(char ch, const string& regexStr) {
-    for (int i = 0; i < regexStr.size(); ++i) {
+bool isCharAllowed(char ch, const char* allowed) {
+    int n = (int)strlen(allowed);
+    for (int i = 0; i < n; ++i) {
         // Handle range like A-Z and
-        if (i + 2 < regexStr.size() && regexStr[i + 1] == '-') {
-            if (ch >= regexStr[i] && ch <= regexStr[i + 2])
+        if (i + 2 < n && allowed[i + 1] == '-') {
+            if (ch >= allowed[i] && ch <= allowed[i + 2])
                 return true;
 
             i += 2; // skip "A-Z"
         }
         // Handle single character like M or F
         else {
-            if (ch == regexStr[i])
+            if (ch == allowed[i])
                 return true;
         }
     }
     return false;
 }
 
-void display(int nChar, char* str, int cursor, int xPos, int yPos, int len){
-    gotoxy(xPos, yPos);
+// Padding for display(), so redrawing a line does not build a string
+static const char BLANKS[MAX_FIELD_LEN + 1] = "                                                  ";
+
+void display(const FormLine& line){
+    Terminal& term = Terminal::getInstance();
+    gotoxy(line.x, line.y);
     textattr(0x071);
-    // Display nChar from str
-    printf("%.*s", nChar, str);
-    if (nChar < len)
+    // Display the line's text
+    term.write(line.text, line.length);
+    if (line.length < line.len)
         // and Fill the gap with Spaces
-        cout << string(len - nChar, ' ');
+        term.write(BLANKS, line.len - line.length);
     textattr(0x007);
-    gotoxy(cursor + xPos, yPos);
+    gotoxy(line.cursor + line.x, line.y);
 }
 
 int displayMenu(const vector<string>& menu, const string& MenuTitle,const string& MenuDescriptionTitle ,  const string& MenuDescription,int YPositionOfESC){
-    const int nOption = menu.size();
-    bool abort = false;
-    int selected = 0;
-    do{
-        system("cls");
-        cout << "\n" << MenuTitle << "\n";
-        gotoxy(0, nOption*2 + YPositionOfESC);
-        cout << "Press ESC to back.";
-
-        gotoxy(2, 2);
-        for(int i = 0; i < nOption; ++i){
-            gotoxy(2, 3+i*2);
-            if (i == selected){
-                textattr(0x070);
-            } else {
-                textattr(0x007);
-            }
-            cout << menu[i];
-        }
-
-        textattr(0x007); // reset colors
-
-        if (MenuDescriptionTitle != ""){
-            cout << "\n" + MenuDescriptionTitle<< endl;
-            if (!MenuDescription.empty())
-                cout << "\n" << MenuDescription << endl;
-        }
+    return displayMenu(menu.size(), [&menu](size_t i) { return menu[i]; }, MenuTitle, MenuDescriptionTitle,
+                       MenuDescription, YPositionOfESC);
+}
 
-        char ch = getch();
-        switch(ch){
-        case -32:{
-            ch = getch();
-            switch(ch){
-            case 72: // Up Arrow
-                selected = (selected - 1 + nOption) % nOption;
-                break;
-            case 80: // Down Arrow
-                selected = (selected + 1) % nOption;
-                break;
-            case 71: // Home Key
-                selected = 0;
-                break;
-            case 79: // End Key
-                selected = nOption - 1;
-                break;
-            }
+int displayMenu(size_t nItems, const function<string(size_t)>& itemText, const string& MenuTitle,
+                const string& MenuDescriptionTitle, const string& MenuDescription, int YPositionOfESC){
+    VirtualMenu menu(nItems, itemText, MenuTitle, MenuDescriptionTitle, MenuDescription, YPositionOfESC);
+    Terminal& term = Terminal::getInstance();
+    string frame;
+    while (true) {
+        // only what changed since the last key press is written
+        frame.clear();
+        menu.render(frame);
+        term.write(frame);
+
+        switch(term.readKey()){
+        case KeyUp: // Up Arrow
+            menu.up();
+            break;
+        case KeyDown: // Down Arrow
+            menu.down();
+            break;
+        case KeyHome: // Home Key
+            menu.home();
+            break;
+        case KeyEnd: // End Key
+            menu.end();
+            break;
+        case KeyPageUp: // Page Up
+            menu.pageUp();
+            break;
+        case KeyPageDown: // Page Down
+            menu.pageDown();
             break;
-        }
         case 27: // Esc Key
+            term.write("\x1b[0m");
             return -1;
         case '\r':// Enter
-            return (selected + 1);
+            term.write("\x1b[0m");
+            return (int)menu.getSelected() + 1;
         }
-    } while(!abort);
-
-    return -1;
+    }
 }
 
 
@@ -318,37 +292,20 @@ int displayMenu(const vector<string>& menu, const string& MenuTitle,const string
 
 // struct Student {
 //     int id;
-//     char name[30];
+//     string name;
 //     char grade;
 // };
 
 
 // int main()
 // {
-//     vector<Field> studentFields = {
-//         {
-//             "ID:",
-//             6, '0', '9',
-//             [](void* o, const char* v) {
-//                 ((Student*)o)->id = atoi(v);
-//             }
-//         },
-//         {
-//             "Name:",
-//             20, 'A', 'z',
-//             [](void* o, const char* v) {
-//                 strcpy(((Student*)o)->name, v);
-//             }
-//         },
-//         {
-//             "Grade:",
-//             1, 'A', 'F',
-//             [](void* o, const char* v) {
-//                 ((Student*)o)->grade = v[0];
-//             }
-//         }
-//     };
+//     static constexpr auto studentForm = makeForm<Student>(
+//         field("ID:", 6, "0-9", &Student::id),
+//         field("Name:", 20, "A-Za-z ", &Student::name),
+//         field("Grade:", 1, "A-F", &Student::grade)
+//     );
+//     static_assert(studentForm.isValid(), "a field is longer than MAX_FIELD_LEN");
 
 //     Student s{};
-//     showForm(&s, studentFields);
+//     showForm(s, studentForm);
 // }
@@ -0,0 +1,86 @@
+// Checkout hold throughput with CheckoutHolds
+// Holds --holds tickets on one general admission event, confirms half of them (take + book), lets
+// the other half expire in one sweep, and times each phase. Then, with --holds holds outstanding,
+// times ticks of the expiry wheel where nothing is due, which should not depend on the hold count.
+// Time is driven by hand (expireUntil with future time points), no background thread.
+//
+//   ticketak-hold-bench [--holds 2000000] [--ticks 5000]
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "CheckoutHolds.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const int nHolds = stoi(argValue(argc, argv, "--holds", "2000000"));
+    const int nTicks = stoi(argValue(argc, argv, "--ticks", "5000"));
+    const auto ttl = chrono::minutes(10);
+    const auto tick = chrono::milliseconds(100);
+
+    Event event(1, "Final Match", Category::Sports, Date{1, 1, 2030},
+        TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 0},
+        TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 0},
+        TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), 2 * nHolds});
+    CheckoutHolds holds([&event](int, const function<void(Event&)>& use) { use(event); }, ttl, tick);
+    const TicketTypePrice regular{TicketType::Regular, Money::pounds(100)};
+
+    vector<uint64_t> ids(nHolds);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < nHolds; ++i) ids[i] = holds.hold(event, i, regular);
+    double holdSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    int confirmed = 0;
+    for (int i = 0; i < nHolds; i += 2) {
+        HeldTickets held;
+        if (holds.take(ids[i], i, held)) {
+            event.bookHeldSeats(held.fanId, held.typePrice, held.range);
+            confirmed++;
+        }
+    }
+    double confirmSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    size_t expired = holds.expireUntil(chrono::steady_clock::now() + ttl + 2 * tick);
+    double expireSeconds = secondsSince(start);
+
+    cout << "phase       count        per sec\n";
+    char line[128];
+    snprintf(line, sizeof(line), "hold    %9d   %12.0f\nconfirm %9d   %12.0f\nexpire  %9zu   %12.0f",
+             nHolds, nHolds / holdSeconds, confirmed, confirmed / confirmSeconds, expired, expired / expireSeconds);
+    cout << line << "\n";
+
+    // every ticket is either booked or back on sale
+    bool consistent = event.getRegularTickets().quantity + (int)event.getTicketCount() == event.getCapacity() &&
+                      event.getHeldTickets(TicketType::Regular) == 0 && holds.size() == 0;
+    cout << "inventory " << (consistent ? "consistent" : "INCONSISTENT") << "\n";
+
+    // Tick cost with many holds outstanding and none due
+    for (int outstanding : {0, nHolds / 100, nHolds}) {
+        CheckoutHolds wheelHolds([&event](int, const function<void(Event&)>& use) { use(event); }, ttl, tick);
+        for (int i = 0; i < outstanding; ++i) wheelHolds.hold(event, i, regular);
+        auto now = chrono::steady_clock::now();
+        start = chrono::steady_clock::now();
+        size_t fired = 0;
+        for (int t = 1; t <= nTicks; ++t) fired += wheelHolds.expireUntil(now + t * tick);
+        double ns = secondsSince(start) * 1e9 / nTicks;
+        snprintf(line, sizeof(line), "%9d holds outstanding: %6.0f ns per tick (%zu fired)", outstanding, ns, fired);
+        cout << line << "\n";
+        wheelHolds.expireUntil(now + ttl + 2 * tick);
+    }
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+// Local load test for the HTTP front end, no external services needed
+// Starts the server in-process on a free loopback port, seeds events and fans, then for each
+// connection count opens that many keep-alive connections (one client thread each) that send a
+// mix of search / event / book / my-tickets requests, and reports requests/sec and p50/p99 latency.
+//
+//   ticketak-http-loadtest [--connections 1,8,32,128] [--seconds 2] [--pipeline 1] [--workers N]
+// --pipeline N sends N requests back to back before reading their N responses.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HttpServer.cpp"
+#include "TicketakHttpApi.cpp"
+
+using namespace std;
+
+// Blocking keep-alive client connection
+class TestClient {
+private:
+    int fd = -1;
+    string buf;
+
+public:
+    ~TestClient() {
+        if (fd != -1) ::close(fd);
+    }
+
+    bool connect(uint16_t port) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) return false;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return ::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0;
+    }
+
+    bool sendAll(const string& data) {
+        for (size_t sent = 0; sent < data.size(); ) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    // Reads one response, returns its status code (or -1) and its body
+    int readResponse(string& body) {
+        while (true) {
+            size_t headerEnd = buf.find("\r\n\r\n");
+            if (headerEnd != string::npos) {
+                size_t cl = buf.find("Content-Length: ");
+                size_t length = cl != string::npos && cl < headerEnd ? strtoul(buf.c_str() + cl + 16, nullptr, 10) : 0;
+                if (buf.size() >= headerEnd + 4 + length) {
+                    int status = atoi(buf.c_str() + 9);
+                    body = buf.substr(headerEnd + 4, length);
+                    buf.erase(0, headerEnd + 4 + length);
+                    return status;
+                }
+            }
+            char chunk[16384];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return -1;
+            buf.append(chunk, n);
+        }
+    }
+
+    static string request(const string& method, const string& target, const string& token = "", const string& body = "") {
+        string out = method + " " + target + " HTTP/1.1\r\nHost: localhost\r\n";
+        if (!token.empty()) out += "Authorization: Bearer " + token + "\r\n";
+        if (!body.empty() || method == "POST") out += "Content-Length: " + to_string(body.size()) + "\r\n";
+        return out + "\r\n" + body;
+    }
+};
+
+struct StepResult {
+    int connections;
+    long long requests = 0, errors = 0;
+    double seconds = 0, p50 = 0, p99 = 0;
+};
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+static StepResult runStep(uint16_t port, int connections, double seconds, int pipeline, int nFans, int nEvents) {
+    StepResult result;
+    result.connections = connections;
+    vector<vector<double>> latencies(connections);
+    atomic<long long> errors{0};
+    const string searches[] = {"Foot", "Rock", "carn", "fair"};
+
+    auto client = [&](int c) {
+        TestClient conn;
+        if (!conn.connect(port)) {
+            errors++;
+            return;
+        }
+        string body;
+        string email = "httpfan" + to_string(c % nFans) + "@ticketak.com";
+        if (!conn.sendAll(TestClient::request("POST", "/login", "",
+                "{\"email\":\"" + email + "\",\"password\":\"password123\"}")) || conn.readResponse(body) != 200) {
+            errors++;
+            return;
+        }
+        string token = body.substr(10, body.size() - 12); // {"token":"..."}
+
+        mt19937 rng(c + 1);
+        auto deadline = chrono::steady_clock::now() + chrono::duration<double>(seconds);
+        string batch;
+        while (chrono::steady_clock::now() < deadline) {
+            batch.clear();
+            for (int p = 0; p < pipeline; ++p) {
+                int kind = rng() % 20;
+                if (kind < 12)
+                    batch += TestClient::request("GET", "/events/search?name=" + searches[rng() % 4]);
+                else if (kind < 16)
+                    batch += TestClient::request("GET", "/events/" + to_string(1 + rng() % nEvents));
+                else if (kind < 19)
+                    batch += TestClient::request("POST", "/events/" + to_string(1 + rng() % nEvents) + "/book",
+                                                 token, "{\"type\":\"Regular\"}");
+                else
+                    batch += TestClient::request("GET", "/me/tickets", token);
+            }
+            auto sent = chrono::steady_clock::now();
+            if (!conn.sendAll(batch)) {
+                errors++;
+                return;
+            }
+            for (int p = 0; p < pipeline; ++p) {
+                int status = conn.readResponse(body);
+                if (status == -1) {
+                    errors++;
+                    return;
+                }
+                // 409 is a sold out tier, an expected answer under load
+                if (status >= 400 && status != 409) errors++;
+                latencies[c].push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - sent).count());
+            }
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int c = 0; c < connections; ++c) threads.emplace_back(client, c);
+    for (thread& t : threads) t.join();
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    result.requests = all.size();
+    result.errors = errors;
+    if (!all.empty()) {
+        result.p50 = all[all.size() / 2];
+        result.p99 = all[min(all.size() - 1, all.size() * 99 / 100)];
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> steps;
+    stringstream list(argValue(argc, argv, "--connections", "1,8,32,128"));
+    for (string item; getline(list, item, ','); ) steps.push_back(stoi(item));
+    const double seconds = stod(argValue(argc, argv, "--seconds", "2"));
+    const int pipeline = max(1, stoi(argValue(argc, argv, "--pipeline", "1")));
+    const int workers = stoi(argValue(argc, argv, "--workers", to_string(max(1u, thread::hardware_concurrency()))));
+    const int nEvents = 100, nFans = 256;
+
+    // Seed data, in memory only
+    const Category categories[] = {Category::Sports, Category::Parties, Category::Carnivals, Category::Other};
+    const string names[] = {"Football Match", "Rock Concert", "City Carnival", "Book Fair"};
+    for (int i = 0; i < nEvents; ++i) {
+        Event e(0, names[i % 4] + " " + to_string(i), categories[i % 4], Date{1 + i % 28, 1 + i % 12, 2030},
+            TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 1000},
+            TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 5000},
+            TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), 100000});
+        EventManager::getInstance().addEvent(e);
+    }
+    for (int i = 0; i < nFans; ++i) {
+        string message;
+        TicketakService::getInstance().registerFan(
+            Fan("Http Fan", "httpfan" + to_string(i) + "@ticketak.com", "password123", 'F', "01000000000"), message);
+    }
+
+    // Bookings are prepaid so the console payment output stays out of the measurement
+    TicketakHttpApi api([](const vector<string>&) { return unique_ptr<PaymentMethod>(new PrepaidPayment()); });
+    HttpServer server([&api](const HttpRequest& req) { return api.handle(req); }, workers);
+    if (!server.listen("127.0.0.1", 0)) {
+        cout << "Could not listen on loopback\n";
+        return 1;
+    }
+    server.start();
+
+    cout << "workers " << workers << ", pipeline " << pipeline << ", " << seconds << " s per step\n";
+    cout << "connections   requests/sec   p50 ms   p99 ms   errors\n";
+    bool clean = true;
+    for (int connections : steps) {
+        StepResult r = runStep(server.port(), connections, seconds, pipeline, nFans, nEvents);
+        char line[128];
+        snprintf(line, sizeof(line), "%11d   %12.0f   %6.3f   %6.3f   %6lld",
+                 r.connections, r.requests / r.seconds, r.p50, r.p99, r.errors);
+        cout << line << "\n";
+        if (r.errors) clean = false;
+    }
+
+    server.stop();
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,505 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+struct HttpRequest {
+    string method;
+    string path;   // target without the query string
+    string query;  // after '?', still URL encoded
+    string body;
+    unordered_map<string, string> headers; // names in lower case
+    bool keepAlive = true;
+
+    string header(const string& name) const {
+        auto it = headers.find(name);
+        return it == headers.end() ? "" : it->second;
+    }
+};
+
+struct HttpResponse {
+    int status = 200;
+    string body;
+    string contentType = "application/json";
+};
+
+using HttpHandler = function<HttpResponse(const HttpRequest&)>;
+
+// Non-blocking HTTP/1.1 server: one epoll thread does all socket I/O and request parsing,
+// a fixed pool of workers runs the handler. Connections are kept alive and may pipeline:
+// the parsed requests of a connection queue up and one worker at a time answers them in order,
+// so different connections are served in parallel while each one gets its responses in sequence.
+// Linux only (epoll).
+class HttpServer {
+public:
+    static constexpr size_t MAX_REQUEST_BYTES = 1 << 20;
+    // Parsed requests a connection may have waiting, the server stops reading it at this many
+    static constexpr size_t MAX_PENDING_REQUESTS = 64;
+
+    explicit HttpServer(HttpHandler handler, unsigned workers = thread::hardware_concurrency())
+        : handler(move(handler)), nWorkers(max(workers, 1u)) {}
+
+    ~HttpServer() {
+        stop();
+        if (reactor.joinable()) reactor.join();
+        if (listenFd != -1) ::close(listenFd);
+        if (epollFd != -1) ::close(epollFd);
+        if (wakeFd != -1) ::close(wakeFd);
+    }
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Binds host:port, port 0 picks a free one (see port())
+    bool listen(const string& host, uint16_t port) {
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd == -1) return false;
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) return false;
+        if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(listenFd, SOMAXCONN) != 0)
+            return false;
+
+        socklen_t len = sizeof(addr);
+        getsockname(listenFd, (sockaddr*)&addr, &len);
+        boundPort = ntohs(addr.sin_port);
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd == -1 || wakeFd == -1) return false;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+        ev.data.fd = wakeFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+        return true;
+    }
+
+    uint16_t port() const { return boundPort; }
+
+    // Serves until stop() is called, on the calling thread
+    void run() {
+        startWorkers();
+        eventLoop();
+        stopWorkers();
+        closeAll();
+    }
+
+    // Serves on a background thread
+    void start() {
+        reactor = thread([this] { run(); });
+    }
+
+    // Only writes to an eventfd, so it is safe from a signal handler
+    void stop() {
+        if (wakeFd == -1) return;
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    // Parses one request at buf[offset...], on success offset moves past it
+    // Returns 1 for a request, 0 when more bytes are needed, -1 for a malformed or too large one
+    static int parseRequest(const string& buf, size_t& offset, HttpRequest& req) {
+        size_t headerEnd = buf.find("\r\n\r\n", offset);
+        if (headerEnd == string::npos)
+            return buf.size() - offset > MAX_REQUEST_BYTES ? -1 : 0;
+
+        size_t lineEnd = buf.find("\r\n", offset);
+        size_t sp1 = buf.find(' ', offset);
+        size_t sp2 = sp1 == string::npos ? string::npos : buf.find(' ', sp1 + 1);
+        if (sp2 == string::npos || sp2 > lineEnd) return -1;
+
+        req = HttpRequest();
+        req.method = buf.substr(offset, sp1 - offset);
+        string target = buf.substr(sp1 + 1, sp2 - sp1 - 1);
+        string version = buf.substr(sp2 + 1, lineEnd - sp2 - 1);
+        if (version != "HTTP/1.1" && version != "HTTP/1.0") return -1;
+        size_t q = target.find('?');
+        req.path = target.substr(0, q);
+        if (q != string::npos) req.query = target.substr(q + 1);
+
+        for (size_t pos = lineEnd + 2; pos < headerEnd; ) {
+            size_t end = buf.find("\r\n", pos);
+            size_t colon = buf.find(':', pos);
+            if (colon == string::npos || colon > end) return -1;
+            string name = buf.substr(pos, colon - pos);
+            for (char& c : name) c = (char)tolower((unsigned char)c);
+            size_t v = colon + 1;
+            while (v < end && (buf[v] == ' ' || buf[v] == '\t')) ++v;
+            size_t vEnd = end;
+            while (vEnd > v && (buf[vEnd - 1] == ' ' || buf[vEnd - 1] == '\t')) --vEnd;
+            req.headers[name] = buf.substr(v, vEnd - v);
+            pos = end + 2;
+        }
+
+        if (!req.header("transfer-encoding").empty()) return -1; // chunked bodies are not supported
+        size_t bodyLength = 0;
+        string contentLength = req.header("content-length");
+        if (!contentLength.empty()) {
+            char* end;
+            unsigned long long n = strtoull(contentLength.c_str(), &end, 10);
+            if (*end != '\0' || n > MAX_REQUEST_BYTES) return -1;
+            bodyLength = (size_t)n;
+        }
+        size_t bodyStart = headerEnd + 4;
+        if (buf.size() - bodyStart < bodyLength) return 0;
+        req.body = buf.substr(bodyStart, bodyLength);
+
+        string connection = req.header("connection");
+        for (char& c : connection) c = (char)tolower((unsigned char)c);
+        req.keepAlive = version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive";
+
+        offset = bodyStart + bodyLength;
+        return 1;
+    }
+
+    static string serialize(const HttpResponse& resp, bool keepAlive) {
+        string out = "HTTP/1.1 " + to_string(resp.status) + " " + statusText(resp.status) + "\r\n";
+        out += "Content-Type: " + resp.contentType + "\r\n";
+        out += "Content-Length: " + to_string(resp.body.size()) + "\r\n";
+        if (!keepAlive) out += "Connection: close\r\n";
+        out += "\r\n";
+        out += resp.body;
+        return out;
+    }
+
+    static const char* statusText(int status) {
+        switch (status) {
+            case 200: return "OK";
+            case 201: return "Created";
+            case 400: return "Bad Request";
+            case 401: return "Unauthorized";
+            case 402: return "Payment Required";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 409: return "Conflict";
+            case 410: return "Gone";
+            case 413: return "Payload Too Large";
+            case 422: return "Unprocessable Entity";
+            default: return status < 500 ? "Error" : "Internal Server Error";
+        }
+    }
+
+private:
+    struct Connection {
+        int fd;
+        mutex m;
+        string in;
+        deque<HttpRequest> pending;
+        string out;
+        size_t outPos = 0;
+        uint32_t interest = EPOLLIN;
+        bool busy = false;             // a worker is answering its pending requests
+        bool peerClosed = false;       // nothing more will be read
+        bool broken = false;           // nothing can be written either, it left epoll already
+        bool closeAfterWrite = false;  // close once out is sent
+        bool closed = false;
+
+        explicit Connection(int fd) : fd(fd) {}
+    };
+
+    HttpHandler handler;
+    unsigned nWorkers;
+    int listenFd = -1, epollFd = -1, wakeFd = -1;
+    uint16_t boundPort = 0;
+    thread reactor;
+
+    mutex connsMutex;
+    unordered_map<int, shared_ptr<Connection>> conns;
+
+    // Worker pool, a job is a connection with pending requests
+    mutex jobsMutex;
+    condition_variable jobsReady;
+    deque<shared_ptr<Connection>> jobs;
+    vector<thread> workers;
+    bool stopping = false;
+
+    void startWorkers() {
+        stopping = false;
+        for (unsigned i = 0; i < nWorkers; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    void stopWorkers() {
+        {
+            lock_guard<mutex> lock(jobsMutex);
+            stopping = true;
+        }
+        jobsReady.notify_all();
+        for (thread& t : workers) t.join();
+        workers.clear();
+    }
+
+    void closeAll() {
+        lock_guard<mutex> lock(connsMutex);
+        for (auto& entry : conns) {
+            lock_guard<mutex> connLock(entry.second->m);
+            ::close(entry.second->fd);
+            entry.second->closed = true;
+        }
+        conns.clear();
+    }
+
+    void eventLoop() {
+        epoll_event events[256];
+        while (true) {
+            int n = epoll_wait(epollFd, events, 256, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == wakeFd) return;
+                if (fd == listenFd) {
+                    acceptAll();
+                    continue;
+                }
+                shared_ptr<Connection> conn;
+                {
+                    lock_guard<mutex> lock(connsMutex);
+                    auto it = conns.find(fd);
+                    if (it == conns.end()) continue;
+                    conn = it->second;
+                }
+                onEvent(conn, events[i].events);
+            }
+        }
+    }
+
+    void acceptAll() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd == -1) return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            auto conn = make_shared<Connection>(fd);
+            {
+                lock_guard<mutex> lock(connsMutex);
+                conns[fd] = conn;
+            }
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+
+    void onEvent(const shared_ptr<Connection>& conn, uint32_t events) {
+        bool dispatch = false;
+        {
+            lock_guard<mutex> lock(conn->m);
+            if (conn->closed) return;
+
+            if (events & (EPOLLERR | EPOLLHUP)) {
+                markBroken(*conn);
+            } else {
+                if (events & EPOLLIN) readRequests(*conn);
+                if (events & EPOLLOUT) flush(*conn);
+            }
+
+            if (!conn->pending.empty() && !conn->busy) {
+                conn->busy = true;
+                dispatch = true;
+            }
+            updateInterest(*conn);
+            maybeClose(*conn);
+        }
+        if (dispatch) {
+            {
+                lock_guard<mutex> lock(jobsMutex);
+                jobs.push_back(conn);
+            }
+            jobsReady.notify_one();
+        }
+    }
+
+    // Reads until the socket is drained or MAX_PENDING_REQUESTS are queued; the rest stays in the
+    // kernel buffer (and in conn.in) until a worker has answered them
+    // Caller holds conn.m
+    void readRequests(Connection& conn) {
+        char buf[16384];
+        while (true) {
+            parseRequests(conn);
+            if (conn.peerClosed || conn.closeAfterWrite || conn.pending.size() >= MAX_PENDING_REQUESTS) return;
+            ssize_t n = recv(conn.fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                conn.in.append(buf, n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n == 0) {
+                conn.peerClosed = true;
+                continue; // parse what is left
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) markBroken(conn);
+            return;
+        }
+    }
+
+    // Queues the complete requests in conn.in, up to MAX_PENDING_REQUESTS
+    // Caller holds conn.m
+    void parseRequests(Connection& conn) {
+        size_t offset = 0;
+        while (!conn.closeAfterWrite && conn.pending.size() < MAX_PENDING_REQUESTS) {
+            HttpRequest req;
+            int parsed = parseRequest(conn.in, offset, req);
+            if (parsed == 0) break;
+            if (parsed < 0) {
+                // answered in order after the requests already queued, then the connection is closed
+                HttpRequest bad; // empty method marks it
+                bad.keepAlive = false;
+                conn.pending.push_back(bad);
+                conn.closeAfterWrite = true;
+                break;
+            }
+            conn.pending.push_back(move(req));
+        }
+        conn.in.erase(0, offset);
+    }
+
+    // Caller holds conn.m
+    void flush(Connection& conn) {
+        while (conn.outPos < conn.out.size()) {
+            ssize_t n = send(conn.fd, conn.out.data() + conn.outPos, conn.out.size() - conn.outPos, MSG_NOSIGNAL);
+            if (n > 0) {
+                conn.outPos += n;
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+            markBroken(conn);
+            return;
+        }
+        conn.out.clear();
+        conn.outPos = 0;
+    }
+
+    // The peer is gone, whatever is queued can not be delivered. The fd leaves epoll at once
+    // so a hang-up is not reported again and again while a worker still owns the connection.
+    // Caller holds conn.m
+    void markBroken(Connection& conn) {
+        if (conn.broken) return;
+        conn.broken = true;
+        conn.peerClosed = true;
+        conn.out.clear();
+        conn.outPos = 0;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, conn.fd, nullptr);
+    }
+
+    // Caller holds conn.m
+    void updateInterest(Connection& conn) {
+        if (conn.closed || conn.broken) return;
+        bool reading = !conn.peerClosed && !conn.closeAfterWrite && conn.pending.size() < MAX_PENDING_REQUESTS;
+        uint32_t interest = (reading ? (uint32_t)EPOLLIN : 0u) |
+                            (conn.outPos < conn.out.size() ? (uint32_t)EPOLLOUT : 0u);
+        if (interest == conn.interest) return;
+        conn.interest = interest;
+        epoll_event ev{};
+        ev.events = interest;
+        ev.data.fd = conn.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev);
+    }
+
+    // Caller holds conn.m
+    void maybeClose(Connection& conn) {
+        if (conn.closed || conn.busy || !conn.out.empty()) return;
+        if (!conn.peerClosed && !conn.closeAfterWrite) return;
+        if (!conn.broken) epoll_ctl(epollFd, EPOLL_CTL_DEL, conn.fd, nullptr);
+        ::close(conn.fd);
+        conn.closed = true;
+        lock_guard<mutex> lock(connsMutex);
+        auto it = conns.find(conn.fd);
+        if (it != conns.end() && it->second.get() == &conn) conns.erase(it);
+    }
+
+    void workerLoop() {
+        while (true) {
+            shared_ptr<Connection> conn;
+            {
+                unique_lock<mutex> lock(jobsMutex);
+                jobsReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                conn = jobs.front();
+                jobs.pop_front();
+            }
+            serve(*conn);
+        }
+    }
+
+    // Answers the pending requests of one connection in order
+    void serve(Connection& conn) {
+        while (true) {
+            HttpRequest req;
+            {
+                lock_guard<mutex> lock(conn.m);
+                // requests left in conn.in while the queue was full
+                if (conn.pending.empty() && !conn.closed && !conn.broken) parseRequests(conn);
+                if (conn.pending.empty() || conn.closed) {
+                    conn.busy = false;
+                    updateInterest(conn);
+                    maybeClose(conn);
+                    return;
+                }
+                req = move(conn.pending.front());
+                conn.pending.pop_front();
+            }
+
+            HttpResponse resp;
+            if (req.method.empty()) {
+                resp.status = 400;
+                resp.body = "{\"error\":\"Malformed request\"}";
+            } else {
+                try {
+                    resp = handler(req);
+                } catch (const exception&) {
+                    resp = HttpResponse{500, "{\"error\":\"Internal error\"}"};
+                }
+            }
+
+            lock_guard<mutex> lock(conn.m);
+            if (conn.closed || conn.broken) {
+                conn.pending.clear();
+                continue;
+            }
+            conn.out += serialize(resp, req.keepAlive);
+            if (!req.keepAlive) {
+                conn.closeAfterWrite = true;
+                conn.pending.clear();
+            }
+            flush(conn);
+            updateInterest(conn);
+        }
+    }
+};
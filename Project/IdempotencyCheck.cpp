@@ -0,0 +1,161 @@
+// Replays booking requests with retries through TicketakService and checks they are deduplicated
+// Sends --requests bookings, --duplicates of them repeats of a recent request's idempotency key (a
+// client retrying after a timeout, possibly while the first try is still running), from --threads
+// threads, then checks that every key booked exactly one ticket and charged exactly once, and that
+// every repeat got the first ticket back. Also checks that one stuck request does not keep a table
+// from evicting its other keys. Exits non-zero if not.
+//
+//   ticketak-idempotency-check [--requests 1000000] [--duplicates 0.2] [--threads N]
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TicketakService.cpp"
+
+using namespace std;
+
+// Charges nothing, counts the charges
+class CountingPayment : public PaymentMethod {
+public:
+    atomic<long long> charges{0};
+
+    bool pay(Money amount) override {
+        charges++;
+        return amount >= Money();
+    }
+
+    // a refunded charge is not counted
+    bool refund(Money amount) override {
+        charges--;
+        return amount >= Money();
+    }
+
+    string provider() const override { return "prepaid"; }
+};
+
+struct ReplayRequest {
+    int fan;
+    int eventId;
+    string key;
+    bool repeat;
+};
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// One action blocks while 100x a stripe's capacity of other keys go through: the table stays at
+// its capacity plus the stuck key, and a repeat of the stuck key still gets its answer
+static bool stuckKeyIsBounded() {
+    const size_t capacity = 64;
+    IdempotencyTable<int> table(capacity, chrono::hours(1), 1);
+    promise<void> release;
+    shared_future<void> released = release.get_future().share();
+    int stuckResult = 0, repeatResult = 0;
+    thread stuck([&] { table.run("stuck", "f", stuckResult, [&] { released.wait(); return 7; }); });
+    while (table.size() == 0) this_thread::yield();
+
+    int r;
+    for (size_t i = 0; i < 100 * capacity; ++i) table.run("key-" + to_string(i), "f", r, [] { return 1; });
+    bool bounded = table.size() <= capacity + 1;
+    release.set_value();
+    stuck.join();
+    IdempotencyOutcome repeat = table.run("stuck", "f", repeatResult, [] { return 0; });
+    return bounded && repeat == IdempotencyOutcome::Replayed && repeatResult == 7;
+}
+
+int main(int argc, char* argv[]) {
+    const int nRequests = stoi(argValue(argc, argv, "--requests", "1000000"));
+    const double duplicates = stod(argValue(argc, argv, "--duplicates", "0.2"));
+    const int nThreads = stoi(argValue(argc, argv, "--threads", to_string(max(1u, thread::hardware_concurrency()))));
+    const int nFans = 64, nEvents = 100;
+
+    TicketakService& service = TicketakService::getInstance();
+    EventManager& eventManager = EventManager::getInstance();
+    vector<int> eventIds;
+    for (int i = 0; i < nEvents; ++i) {
+        Event e(0, "Replay Event " + to_string(i), Category::Sports, Date{1, 1, 2030},
+            TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 0},
+            TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 0},
+            TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), nRequests});
+        eventManager.addEvent(e);
+        eventIds.push_back(e.getId());
+    }
+    vector<string> tokens(nFans);
+    for (int i = 0; i < nFans; ++i) {
+        string message, email = "replayfan" + to_string(i) + "@ticketak.com";
+        service.registerFan(Fan("Replay Fan", email, "password123", 'F', "01000000000"), message);
+        if (service.login(LoginDTO{email, "password123"}, UserType::Fan, tokens[i]) != ServiceStatus::Ok) {
+            cout << "Login failed\n";
+            return 1;
+        }
+    }
+
+    // A repeat reuses one of the last 1000 requests, so some arrive while the first try still runs
+    mt19937 rng(7);
+    vector<ReplayRequest> requests;
+    requests.reserve(nRequests);
+    int uniqueKeys = 0;
+    for (int i = 0; i < nRequests; ++i) {
+        if (i > 0 && uniform_real_distribution<double>(0, 1)(rng) < duplicates) {
+            ReplayRequest repeat = requests[i - 1 - rng() % min(i, 1000)];
+            repeat.repeat = true;
+            requests.push_back(repeat);
+        } else {
+            requests.push_back(ReplayRequest{(int)(rng() % nFans), eventIds[rng() % nEvents], "req-" + to_string(i), false});
+            uniqueKeys++;
+        }
+    }
+
+    CountingPayment payment;
+    vector<Ticket> answers(nRequests);
+    vector<ServiceStatus> statuses(nRequests);
+    atomic<long long> freshNanos{0}, repeatNanos{0};
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = t; i < nRequests; i += nThreads) {
+                const ReplayRequest& req = requests[i];
+                auto sent = chrono::steady_clock::now();
+                statuses[i] = service.bookTicket(tokens[req.fan], req.eventId, TicketType::Regular, payment, answers[i], req.key);
+                long long nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - sent).count();
+                (req.repeat ? repeatNanos : freshNanos) += nanos;
+            }
+        });
+    }
+    for (thread& t : threads) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Same key -> same ticket, and one ticket and one charge per key
+    bool ok = true;
+    bool bounded = stuckKeyIsBounded();
+    unordered_map<string, uint64_t> firstTicket;
+    for (int i = 0; i < nRequests; ++i) {
+        if (statuses[i] != ServiceStatus::Ok) ok = false;
+        uint64_t ticket = answers[i].getId();
+        auto inserted = firstTicket.emplace(to_string(requests[i].fan) + ":" + requests[i].key, ticket);
+        if (!inserted.second && inserted.first->second != ticket) ok = false;
+    }
+    long long booked = 0;
+    for (int id : eventIds) booked += eventManager.getEvent(id)->getTicketCount();
+    if (booked != uniqueKeys || payment.charges != uniqueKeys) ok = false;
+
+    int repeats = nRequests - uniqueKeys;
+    cout << nRequests << " requests (" << repeats << " repeats) on " << nThreads << " threads in " << seconds << " s ("
+         << (long long)(nRequests / seconds) << " requests/sec)\n"
+         << "  unique keys " << uniqueKeys << ", tickets booked " << booked << ", charges " << payment.charges << "\n"
+         << "  mean latency: first try " << freshNanos / max(uniqueKeys, 1) / 1000.0 << " us, repeat "
+         << repeatNanos / max(repeats, 1) / 1000.0 << " us\n"
+         << "  deduplication " << (ok ? "correct" : "BROKEN") << "\n"
+         << "  table with a stuck request " << (bounded ? "bounded" : "UNBOUNDED") << "\n";
+    return ok && bounded ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+enum class IdempotencyOutcome {
+    Fresh,     // first time this key was seen, the action ran
+    Replayed,  // a repeat, the first call's result was returned
+    Conflict   // the key was used before for a different request
+};
+
+// Remembers the result of each keyed request so a retried request gets the original result instead
+// of being done again. The first call with a key runs the action; a repeat while it still runs
+// waits for it, a later one costs one hash lookup. The fingerprint describes the request (e.g. event
+// and ticket type), the same key sent with a different request is refused as a conflict.
+//
+// Bounded: keys are split over stripes, each with its own mutex, hash map and LRU list, and a stripe
+// over its share of the capacity forgets its least recently used keys. Keys also expire after ttl.
+// A key whose action is still running is never evicted, eviction passes over it to older keys, so
+// a stripe is over its share by at most the actions running in it.
+template <typename Result>
+class IdempotencyTable {
+public:
+    using Clock = chrono::steady_clock;
+
+    explicit IdempotencyTable(size_t capacity = 1 << 20, chrono::seconds ttl = chrono::hours(24), unsigned nStripes = 64)
+        : ttl(ttl), stripes(max(nStripes, 1u)) {
+        stripeCapacity = max<size_t>(capacity / stripes.size(), 1);
+    }
+
+    IdempotencyTable(const IdempotencyTable&) = delete;
+    IdempotencyTable& operator=(const IdempotencyTable&) = delete;
+
+    IdempotencyOutcome run(const string& key, const string& fingerprint, Result& result, const function<Result()>& action) {
+        Stripe& stripe = stripes[hash<string>()(key) % stripes.size()];
+        auto now = Clock::now();
+        promise<Result> mine;
+        unique_lock<mutex> lock(stripe.stripeMutex);
+        auto it = stripe.index.find(key);
+        if (it != stripe.index.end() && it->second->expires <= now) {
+            stripe.lru.erase(it->second);
+            stripe.index.erase(it);
+            it = stripe.index.end();
+        }
+        if (it != stripe.index.end()) {
+            if (it->second->fingerprint != fingerprint) return IdempotencyOutcome::Conflict;
+            stripe.lru.splice(stripe.lru.begin(), stripe.lru, it->second);
+            shared_future<Result> original = it->second->result;
+            lock.unlock();
+            result = original.get();
+            return IdempotencyOutcome::Replayed;
+        }
+        stripe.lru.push_front(Entry{key, fingerprint, now + ttl, mine.get_future().share()});
+        stripe.index[key] = stripe.lru.begin();
+        evict(stripe, now);
+        lock.unlock();
+
+        // a throwing action answers its waiting repeats with the same exception
+        try {
+            result = action();
+        } catch (...) {
+            mine.set_exception(current_exception());
+            throw;
+        }
+        mine.set_value(result);
+        return IdempotencyOutcome::Fresh;
+    }
+
+    size_t size() {
+        size_t total = 0;
+        for (Stripe& stripe : stripes) {
+            lock_guard<mutex> lock(stripe.stripeMutex);
+            total += stripe.index.size();
+        }
+        return total;
+    }
+
+private:
+    struct Entry {
+        string key;
+        string fingerprint;
+        Clock::time_point expires;
+        shared_future<Result> result;
+    };
+
+    struct Stripe {
+        mutex stripeMutex;
+        list<Entry> lru; // most recent first
+        unordered_map<string, typename list<Entry>::iterator> index;
+    };
+
+    chrono::seconds ttl;
+    size_t stripeCapacity;
+    vector<Stripe> stripes;
+
+    // Caller holds the stripe's mutex
+    void evict(Stripe& stripe, Clock::time_point now) {
+        auto it = stripe.lru.end();
+        while (it != stripe.lru.begin()) {
+            --it;
+            bool over = stripe.index.size() > stripeCapacity;
+            if (!over && it->expires > now) break;
+            // still running, its repeats must find it; the next newer entry goes instead
+            if (it->result.wait_for(chrono::seconds(0)) != future_status::ready) continue;
+            stripe.index.erase(it->key);
+            it = stripe.lru.erase(it);
+        }
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdlib>
+#include <cctype>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// Minimal JSON support for the import files and the HTTP API:
+// reading flat objects, and escaping strings for the hand-written responses.
+namespace Json {
+
+    inline void skipSpaces(const string& s, size_t& i) {
+        while (i < s.size() && isspace((unsigned char)s[i])) ++i;
+    }
+
+    // s[i] must be the opening quote, i ends after the closing one
+    inline bool parseString(const string& s, size_t& i, string& out) {
+        out.clear();
+        if (i >= s.size() || s[i] != '"') return false;
+        for (++i; i < s.size(); ++i) {
+            char c = s[i];
+            if (c == '"') { ++i; return true; }
+            if (c != '\\') { out += c; continue; }
+            if (++i >= s.size()) return false;
+            switch (s[i]) {
+                case '"': case '\\': case '/': out += s[i]; break;
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    // only code points below 0x80 are kept as they are
+                    if (i + 4 >= s.size()) return false;
+                    unsigned code = strtoul(s.substr(i + 1, 4).c_str(), nullptr, 16);
+                    out += code < 0x80 ? (char)code : '?';
+                    i += 4;
+                    break;
+                }
+                default: return false;
+            }
+        }
+        return false;
+    }
+
+    // Parses a flat JSON object into values ordered like columns, missing keys stay empty
+    // Values may be strings, numbers, true/false or null, nested objects and arrays are rejected.
+    inline bool parseFlatObject(const string& line, const vector<string>& columns, vector<string>& values) {
+        values.assign(columns.size(), "");
+        size_t i = 0;
+        skipSpaces(line, i);
+        if (i >= line.size() || line[i++] != '{') return false;
+        skipSpaces(line, i);
+        if (i < line.size() && line[i] == '}') return true;
+
+        string key, value;
+        while (true) {
+            skipSpaces(line, i);
+            if (!parseString(line, i, key)) return false;
+            skipSpaces(line, i);
+            if (i >= line.size() || line[i++] != ':') return false;
+            skipSpaces(line, i);
+            if (i < line.size() && line[i] == '"') {
+                if (!parseString(line, i, value)) return false;
+            } else {
+                size_t start = i;
+                while (i < line.size() && line[i] != ',' && line[i] != '}' && !isspace((unsigned char)line[i])) ++i;
+                value.assign(line, start, i - start);
+                if (value.empty() || value[0] == '{' || value[0] == '[') return false;
+                if (value == "null") value.clear();
+            }
+
+            auto it = find(columns.begin(), columns.end(), key);
+            if (it != columns.end()) values[it - columns.begin()] = value;
+
+            skipSpaces(line, i);
+            if (i >= line.size()) return false;
+            if (line[i] == '}') return true;
+            if (line[i++] != ',') return false;
+        }
+    }
+
+    // s as a quoted JSON string
+    inline string quote(const string& s) {
+        string out;
+        out.reserve(s.size() + 2);
+        out += '"';
+        for (unsigned char c : s) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char buf[8];
+                        snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out += buf;
+                    } else {
+                        out += (char)c;
+                    }
+            }
+        }
+        out += '"';
+        return out;
+    }
+}
@@ -0,0 +1,150 @@
+// Load generator for the headless TicketakService
+// Registers fans, seeds events, then drives login/list/search/book/my-tickets from many threads
+// and reports the throughput, checking at the end that no tier was oversold.
+//
+//   ticketak-loadgen [--fans N] [--events N] [--threads N] [--ops N] [--data DIR]
+// --data also opens the storage in DIR so every booking goes through the write-ahead log.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+
+#include "TicketakService.cpp"
+
+using namespace std;
+
+struct LoadCounters {
+    atomic<long long> logins{0}, lists{0}, searches{0}, bookings{0}, soldOut{0}, ticketLists{0}, failures{0};
+};
+
+static int intArg(int argc, char* argv[], const string& name, int fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return atoi(argv[i + 1]);
+    }
+    return fallback;
+}
+
+static string stringArg(int argc, char* argv[], const string& name) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return "";
+}
+
+int main(int argc, char* argv[]) {
+    const int nFans = intArg(argc, argv, "--fans", 1000);
+    const int nEvents = intArg(argc, argv, "--events", 200);
+    const int nThreads = intArg(argc, argv, "--threads", max(1u, thread::hardware_concurrency()));
+    const int opsPerThread = intArg(argc, argv, "--ops", 20000);
+    const string dataDir = stringArg(argc, argv, "--data");
+
+    if (!dataDir.empty() && !StorageManager::getInstance().open(dataDir)) {
+        cout << "Could not open storage in " << dataDir << "\n";
+        return 1;
+    }
+
+    TicketakService& service = TicketakService::getInstance();
+    const Category categories[] = {Category::Sports, Category::Parties, Category::Carnivals, Category::Other};
+    const string names[] = {"Football Match", "Rock Concert", "City Carnival", "Book Fair"};
+
+    // Seed: events go straight to EventManager (the service has no admin calls), fans register through the service
+    EventManager& eventManager = EventManager::getInstance();
+    vector<int> eventIds;
+    for (int i = 0; i < nEvents; ++i) {
+        Event e(0, names[i % 4] + " " + to_string(i), categories[i % 4], Date{1 + i % 28, 1 + i % 12, 2030},
+            TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 20},
+            TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 60},
+            TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), 120});
+        eventManager.addEvent(e);
+        eventIds.push_back(e.getId());
+    }
+
+    vector<string> emails;
+    for (int i = 0; i < nFans; ++i) {
+        string email = "loadfan" + to_string(i) + "@ticketak.com";
+        string message;
+        ServiceStatus status = service.registerFan(Fan("Load Fan", email, "password123", 'M', "01000000000"), message);
+        if (status != ServiceStatus::Ok && status != ServiceStatus::EmailInUse) {
+            cout << "Register failed: " << message << "\n";
+            return 1;
+        }
+        emails.push_back(email);
+    }
+
+    LoadCounters counters;
+    auto worker = [&](int threadNo) {
+        mt19937 rng(threadNo + 1);
+        PrepaidPayment payment;
+        string token;
+        for (int op = 0; op < opsPerThread; ++op) {
+            // a fresh login every 100 operations, as a different fan
+            if (op % 100 == 0) {
+                if (!token.empty()) service.logout(token);
+                LoginDTO credentials{emails[rng() % emails.size()], "password123"};
+                if (service.login(credentials, UserType::Fan, token) != ServiceStatus::Ok) {
+                    counters.failures++;
+                    continue;
+                }
+                counters.logins++;
+            }
+
+            int kind = rng() % 10;
+            if (kind == 0) {
+                service.listEvents();
+                counters.lists++;
+            } else if (kind <= 2) {
+                service.searchByName(names[rng() % 4].substr(0, 4));
+                counters.searches++;
+            } else if (kind == 3) {
+                service.searchByCategory(categories[rng() % 4]);
+                counters.searches++;
+            } else if (kind <= 8) {
+                Ticket ticket;
+                TicketType type = (TicketType)(rng() % 3);
+                ServiceStatus status = service.bookTicket(token, eventIds[rng() % eventIds.size()], type, payment, ticket);
+                if (status == ServiceStatus::Ok) counters.bookings++;
+                else if (status == ServiceStatus::SoldOut) counters.soldOut++;
+                else counters.failures++;
+            } else {
+                vector<Ticket> tickets;
+                if (service.myTickets(token, tickets) == ServiceStatus::Ok) counters.ticketLists++;
+                else counters.failures++;
+            }
+        }
+        if (!token.empty()) service.logout(token);
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int t = 0; t < nThreads; ++t) pool.emplace_back(worker, t);
+    for (thread& t : pool) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Every booked ticket must be in exactly one event's log, and no tier below zero
+    long long booked = 0;
+    bool consistent = true;
+    for (int id : eventIds) {
+        Event* e = eventManager.getEvent(id);
+        booked += e->getTicketCount();
+        int remaining = e->getVipTickets().quantity + e->getEconomicTickets().quantity + e->getRegularTickets().quantity;
+        if (e->getVipTickets().quantity < 0 || e->getEconomicTickets().quantity < 0 || e->getRegularTickets().quantity < 0 ||
+            remaining + (int)e->getTicketCount() != e->getCapacity())
+            consistent = false;
+    }
+    if (booked != counters.bookings) consistent = false;
+
+    long long total = (long long)nThreads * opsPerThread;
+    cout << nThreads << " threads, " << total << " operations in " << seconds << " s ("
+         << (long long)(total / seconds) << " ops/sec)\n"
+         << "  logins " << counters.logins << ", lists " << counters.lists << ", searches " << counters.searches
+         << ", bookings " << counters.bookings << " (+" << counters.soldOut << " sold out)"
+         << ", my tickets " << counters.ticketLists << ", failures " << counters.failures << "\n"
+         << "  inventory " << (consistent ? "consistent" : "INCONSISTENT") << "\n";
+
+    StorageManager::getInstance().close();
+    return consistent && counters.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+// Cost of redrawing a menu on a key press, the old displayMenu against VirtualMenu
+// For 10, 10k and 1M entries: the old way builds every entry's string up front (getEventsMenu) and
+// repaints the whole list after a clear on each key, VirtualMenu asks for the visible entries only
+// and writes what changed. Both write into a string, so the numbers leave out the terminal's own time
+// (which grows with the bytes written). Exits non-zero if VirtualMenu ends on the wrong entry.
+//
+//   ticketak-menu-bench [--keys 1000]
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "VirtualMenu.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// What Event::viewDetailsBreifly returns
+static string entryText(size_t i) {
+    return "Event #" + to_string(i + 1) + ", Name: Event " + to_string(i + 1) + ", Category: Sports, Date: 01-01-2099";
+}
+
+static void moveTo(string& out, int x, int y) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "\x1b[%d;%dH", y + 1, x + 1);
+    out += buf;
+}
+
+// One frame of the old displayMenu: clear, title, every entry, ESC hint
+static void oldFrame(string& out, const vector<string>& menu, size_t selected) {
+    out += "\x1b[H\x1b[2J\n=======Menu======\n";
+    moveTo(out, 0, (int)menu.size() * 2 + 3);
+    out += "Press ESC to back.";
+    for (size_t i = 0; i < menu.size(); ++i) {
+        moveTo(out, 2, 3 + (int)i * 2);
+        out += i == selected ? "\x1b[7m" : "\x1b[0m";
+        out += menu[i];
+    }
+    out += "\x1b[0m";
+}
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const int nKeys = stoi(argValue(argc, argv, "--keys", "1000"));
+    bool ok = true;
+    cout << "entries     old build     old us/key  old KB/key    virtual us/key  virtual B/key" << endl;
+
+    for (size_t nItems : {(size_t)10, (size_t)10000, (size_t)1000000}) {
+        // old: build all the strings once, then a full repaint per key (fewer keys on big lists)
+        auto start = chrono::steady_clock::now();
+        vector<string> menu;
+        menu.reserve(nItems);
+        for (size_t i = 0; i < nItems; ++i) menu.push_back(entryText(i));
+        double buildMs = seconds(start) * 1e3;
+        int oldKeys = nItems >= 1000000 ? 5 : nItems >= 10000 ? 50 : nKeys;
+        string frame;
+        size_t oldBytes = 0;
+        start = chrono::steady_clock::now();
+        for (int k = 0; k < oldKeys; ++k) {
+            frame.clear();
+            oldFrame(frame, menu, (size_t)(k + 1) % nItems);
+            oldBytes += frame.size();
+        }
+        double oldMicros = seconds(start) * 1e6 / oldKeys;
+
+        // virtual: down arrows (scrolling once past the window), with a page down every 50 keys
+        VirtualMenu view(nItems, entryText, "=======Menu======");
+        frame.clear();
+        view.render(frame);
+        size_t expected = 0, virtualBytes = 0;
+        start = chrono::steady_clock::now();
+        for (int k = 0; k < nKeys; ++k) {
+            if (k % 50 == 49) {
+                view.pageDown();
+                expected = min(nItems - 1, expected + min<size_t>(nItems, 15));
+            } else {
+                view.down();
+                expected = (expected + 1) % nItems;
+            }
+            frame.clear();
+            view.render(frame);
+            virtualBytes += frame.size();
+        }
+        double virtualMicros = seconds(start) * 1e6 / nKeys;
+        ok = ok && view.getSelected() == expected;
+
+        char line[160];
+        snprintf(line, sizeof(line), "%8zu  %9.2f ms  %12.2f  %10.1f  %16.2f  %13.0f", nItems, buildMs, oldMicros,
+                 oldBytes / 1024.0 / oldKeys, virtualMicros, (double)virtualBytes / nKeys);
+        cout << line << endl;
+    }
+
+    cout << (ok ? "selection checks passed" : "selection checks FAILED") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// Amount of money in piastres (1/100 EGP), so sums over millions of sales stay exact and cost one
+// integer add each. Built with Money::pounds / Money::fromPiastres, or Money::parse for user input;
+// fromDouble rounds to the nearest piastre (used where a price still arrives as a double, e.g. the
+// binary formats on disk). Prints as "500.00".
+class Money {
+private:
+    int64_t value = 0;
+
+    constexpr explicit Money(int64_t piastres) : value(piastres) {}
+
+public:
+    static constexpr int64_t PIASTRES_PER_POUND = 100;
+    // longest output of format(), "-92233720368547758.08"
+    static constexpr size_t MAX_CHARS = 21;
+
+    constexpr Money() = default;
+
+    static constexpr Money pounds(int64_t egp) { return Money(egp * PIASTRES_PER_POUND); }
+    static constexpr Money fromPiastres(int64_t piastres) { return Money(piastres); }
+    static Money fromDouble(double egp) { return Money((int64_t)llround(egp * PIASTRES_PER_POUND)); }
+
+    // "500", "500.5", "500.25", "-3.10"; false for anything else, including more than 2 decimals
+    static bool parse(const char* s, Money& amount) {
+        bool negative = *s == '-';
+        if (negative) s++;
+        int64_t whole = 0, fraction = 0;
+        int digits = 0, decimals = 0;
+        for (; *s >= '0' && *s <= '9'; ++s, ++digits) {
+            if (whole > (INT64_MAX / PIASTRES_PER_POUND - 9) / 10) return false;
+            whole = whole * 10 + (*s - '0');
+        }
+        if (*s == '.') {
+            for (++s; *s >= '0' && *s <= '9'; ++s, ++decimals) {
+                if (decimals == 2) return false;
+                fraction = fraction * 10 + (*s - '0');
+            }
+            if (decimals == 1) fraction *= 10;
+        }
+        if (*s != '\0' || (digits == 0 && decimals == 0)) return false;
+        int64_t piastres = whole * PIASTRES_PER_POUND + fraction;
+        amount = Money(negative ? -piastres : piastres);
+        return true;
+    }
+
+    static bool parse(const string& s, Money& amount) { return parse(s.c_str(), amount); }
+
+    constexpr int64_t piastres() const { return value; }
+    double toDouble() const { return (double)value / PIASTRES_PER_POUND; }
+
+    constexpr Money operator+(Money other) const { return Money(value + other.value); }
+    constexpr Money operator-(Money other) const { return Money(value - other.value); }
+    constexpr Money operator-() const { return Money(-value); }
+    constexpr Money operator*(int64_t n) const { return Money(value * n); }
+    Money& operator+=(Money other) { value += other.value; return *this; }
+    Money& operator-=(Money other) { value -= other.value; return *this; }
+
+    constexpr bool operator==(Money other) const { return value == other.value; }
+    constexpr bool operator!=(Money other) const { return value != other.value; }
+    constexpr bool operator<(Money other) const { return value < other.value; }
+    constexpr bool operator<=(Money other) const { return value <= other.value; }
+    constexpr bool operator>(Money other) const { return value > other.value; }
+    constexpr bool operator>=(Money other) const { return value >= other.value; }
+
+    // Writes "pounds.piastres" to out (at least MAX_CHARS long, not terminated), returns the length
+    // Digits are produced two at a time from a table, no printf and no allocation
+    size_t format(char* out) const {
+        static const char pairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+        uint64_t whole = magnitude / PIASTRES_PER_POUND;
+        uint32_t fraction = (uint32_t)(magnitude % PIASTRES_PER_POUND);
+
+        char digits[MAX_CHARS];
+        char* end = digits + sizeof(digits);
+        char* p = end;
+        *--p = pairs[fraction * 2 + 1];
+        *--p = pairs[fraction * 2];
+        *--p = '.';
+        do {
+            if (whole >= 10) {
+                uint32_t two = (uint32_t)(whole % 100);
+                whole /= 100;
+                *--p = pairs[two * 2 + 1];
+                *--p = pairs[two * 2];
+            } else {
+                *--p = (char)('0' + whole);
+                whole = 0;
+            }
+        } while (whole > 0);
+        if (value < 0) *--p = '-';
+        size_t length = (size_t)(end - p);
+        memcpy(out, p, length);
+        return length;
+    }
+
+    string toString() const {
+        char buf[MAX_CHARS];
+        return string(buf, format(buf));
+    }
+};
+
+inline ostream& operator<<(ostream& out, Money amount) {
+    char buf[Money::MAX_CHARS];
+    return out.write(buf, (streamsize)amount.format(buf));
+}
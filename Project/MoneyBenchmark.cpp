@@ -0,0 +1,110 @@
+// Money (int64 piastres) against the double prices it replaced
+// Sums --sales ticket prices as double and as Money (and an event's revenue from the TicketStore price
+// column), reporting time and how far the double total is from the exact one, then formats --formats
+// prices the old ways (to_string(double), snprintf "%.2f") and with Money::toString / Money::format.
+// Exits non-zero if Money::format and Money::parse disagree with snprintf on any sampled price.
+//
+//   ticketak-money-bench [--sales 10000000] [--formats 1000000]
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Event.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+template <typename F>
+static double nanosPer(long long n, F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / n;
+}
+
+static void report(const char* name, double nanos, const string& note = "") {
+    char line[160];
+    snprintf(line, sizeof(line), "  %-28s %8.2f ns/op  %s", name, nanos, note.c_str());
+    cout << line << endl;
+}
+
+int main(int argc, char* argv[]) {
+    const long long nSales = stoll(argValue(argc, argv, "--sales", "10000000"));
+    const long long nFormats = stoll(argValue(argc, argv, "--formats", "1000000"));
+
+    // prices between 50.00 and 2000.00 EGP, in steps of 0.05 like the ticket tiers
+    mt19937_64 rng(42);
+    uniform_int_distribution<int64_t> steps(1000, 40000);
+    vector<Money> prices(nSales);
+    vector<double> asDouble(nSales);
+    for (long long i = 0; i < nSales; ++i) {
+        prices[i] = Money::fromPiastres(steps(rng) * 5);
+        asDouble[i] = prices[i].toDouble();
+    }
+
+    cout << "sum of " << nSales << " prices" << endl;
+    double doubleTotal = 0;
+    report("double", nanosPer(nSales, [&] {
+        for (double p : asDouble) doubleTotal += p;
+    }));
+    Money total;
+    report("Money", nanosPer(nSales, [&] {
+        for (Money p : prices) total += p;
+    }));
+
+    // the same sales booked into one event, revenue summed from the store's price column
+    Event event(1, "Revenue", Category::Sports, Date{1, 1, 2099}, TicketTypePriceQuantity{TicketType::VIP, Money(), 0},
+                TicketTypePriceQuantity{TicketType::Economic, Money(), 0},
+                TicketTypePriceQuantity{TicketType::Regular, Money(), (int)nSales});
+    for (long long i = 0; i < nSales; ++i) event.bookEvent(1, TicketTypePrice{TicketType::Regular, prices[i]});
+    Money revenue;
+    report("Event::getRevenue (store)", nanosPer(nSales, [&] { revenue = event.getRevenue(); }));
+
+    Money rounded = Money::fromDouble(doubleTotal);
+    cout << "  exact total " << total << " EGP, store revenue " << revenue << " EGP" << endl;
+    char drift[160];
+    snprintf(drift, sizeof(drift), "  double total %.6f EGP (%+.6f EGP from exact, %s to the piastre)", doubleTotal,
+             doubleTotal - total.toDouble(), rounded == total ? "rounds back" : "does NOT round back");
+    cout << drift << endl;
+
+    cout << "format " << nFormats << " prices" << endl;
+    size_t sink = 0;
+    report("to_string(double)", nanosPer(nFormats, [&] {
+        for (long long i = 0; i < nFormats; ++i) sink += to_string(asDouble[i % nSales]).size();
+    }), "\"" + to_string(asDouble[0]) + "\"");
+    char buf[32];
+    report("snprintf %.2f", nanosPer(nFormats, [&] {
+        for (long long i = 0; i < nFormats; ++i) sink += snprintf(buf, sizeof(buf), "%.2f", asDouble[i % nSales]);
+    }));
+    report("Money::toString", nanosPer(nFormats, [&] {
+        for (long long i = 0; i < nFormats; ++i) sink += prices[i % nSales].toString().size();
+    }), "\"" + prices[0].toString() + "\"");
+    report("Money::format (no string)", nanosPer(nFormats, [&] {
+        for (long long i = 0; i < nFormats; ++i) sink += prices[i % nSales].format(buf);
+    }));
+
+    // format and parse against snprintf on small, large and negative amounts
+    bool ok = sink > 0 && revenue == total;
+    uniform_int_distribution<int64_t> any(-1000000000000LL, 1000000000000LL);
+    for (int i = 0; i < 1000000 && ok; ++i) {
+        int64_t piastres = i < 100000 ? i - 50000 : any(rng);
+        Money m = Money::fromPiastres(piastres);
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%s%lld.%02lld", piastres < 0 ? "-" : "",
+                 (long long)(llabs(piastres) / 100), (long long)(llabs(piastres) % 100));
+        Money parsed;
+        ok = m.toString() == expected && Money::parse(expected, parsed) && parsed == m;
+        if (!ok) cout << "mismatch: " << piastres << " -> " << m.toString() << ", expected " << expected << endl;
+    }
+    cout << (ok ? "format/parse checks passed" : "format/parse checks FAILED") << endl;
+    return ok ? 0 : 1;
+}
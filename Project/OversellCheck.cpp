@@ -0,0 +1,95 @@
+// Concurrent buyers on one event: nothing is oversold, and bookings/sec as threads are added
+// For each thread count, a fresh event with --tickets general admission tickets and a numbered
+// tier of the same size is booked by that many threads at once, each trying until both tiers are
+// sold out (1 ticket or a block of 4 seats per call). Exits non-zero if a tier sold more or fewer
+// than it had, a seat was sold twice, or the event's ticket log and counters disagree.
+//
+//   ticketak-oversell-check [--threads 1,2,4,8,16] [--tickets 200000]
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "Event.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> steps;
+    stringstream list(argValue(argc, argv, "--threads", "1,2,4,8,16"));
+    for (string item; getline(list, item, ','); ) steps.push_back(stoi(item));
+    // a multiple of the 100 seat rows, so blocks of 4 fill the numbered tier exactly
+    const int nTickets = stoi(argValue(argc, argv, "--tickets", "200000")) / 100 * 100;
+    const TicketTypePrice regular{TicketType::Regular, Money::pounds(100)};
+    const TicketTypePrice vip{TicketType::VIP, Money::pounds(500)};
+
+    bool ok = true;
+    cout << nTickets << " general admission + " << nTickets << " numbered seats per step\n";
+    cout << "threads   bookings/sec   general sold   seats sold\n";
+    for (int nThreads : steps) {
+        Event event(1, "Final Match", Category::Sports, Date{1, 1, 2099},
+            TicketTypePriceQuantity{TicketType::VIP, vip.price, 0},
+            TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 0},
+            TicketTypePriceQuantity{TicketType::Regular, regular.price, nTickets});
+        event.setSeatMap(TicketType::VIP, SeatLayout::uniform(4, nTickets / 400, 100));
+
+        atomic<long long> generalSold{0}, seatsSold{0}, calls{0};
+        vector<vector<Ticket>> seated(nThreads);
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (int t = 0; t < nThreads; ++t) {
+            threads.emplace_back([&, t] {
+                bool generalLeft = true, seatsLeft = true;
+                while (generalLeft || seatsLeft) {
+                    if (generalLeft) {
+                        calls++;
+                        if (event.bookEvent(t + 1, regular).isValid()) generalSold++;
+                        else generalLeft = false;
+                    }
+                    if (seatsLeft) {
+                        calls++;
+                        vector<Ticket> block = event.bookEvent(t + 1, vip, 4);
+                        seatsSold += (long long)block.size();
+                        seatsLeft = !block.empty();
+                        seated[t].insert(seated[t].end(), block.begin(), block.end());
+                    }
+                }
+            });
+        }
+        for (thread& t : threads) t.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        set<tuple<int, int, int>> seats;
+        for (const vector<Ticket>& mine : seated) {
+            for (const Ticket& ticket : mine) {
+                Seat s = ticket.getSeat();
+                if (!seats.insert(make_tuple(s.section, s.row, s.number)).second) ok = false;
+            }
+        }
+        ok = ok && generalSold == nTickets && seatsSold == nTickets && (long long)seats.size() == seatsSold &&
+             event.getTicketCount() == (size_t)(2 * nTickets) && event.getTicketIds().size() == (size_t)(2 * nTickets) &&
+             event.getRegularTickets().quantity == 0 && event.getVipTickets().quantity == 0 &&
+             event.getRevenue() == regular.price * nTickets + vip.price * nTickets;
+
+        char line[128];
+        snprintf(line, sizeof(line), "%7d   %12.0f   %12lld   %10lld", nThreads, (generalSold + seatsSold) / seconds,
+                 (long long)generalSold, (long long)seatsSold);
+        cout << line << "\n";
+    }
+
+    cout << (ok ? "oversell checks passed" : "oversell checks FAILED") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+// Payment throughput through PaymentPipeline against a slow gateway
+// Keeps --checkouts payments in flight (each answered checkout pays again at once, half by Fawry and
+// half by card) against a MockGateway that takes --latency-ms per settle() call, for --seconds per
+// step, and reports payments/sec and p50/p99 payment latency for each batch size. Batch size 1 is
+// the unbatched baseline: one gateway round trip per payment on each worker.
+//
+//   ticketak-payment-bench [--latency-ms 50] [--checkouts 1000] [--workers 8] [--batches 1,16,256] [--seconds 3]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "PaymentPipeline.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+int main(int argc, char* argv[]) {
+    const int latencyMs = stoi(argValue(argc, argv, "--latency-ms", "50"));
+    const int nCheckouts = stoi(argValue(argc, argv, "--checkouts", "1000"));
+    const unsigned nWorkers = stoul(argValue(argc, argv, "--workers", "8"));
+    const double seconds = stod(argValue(argc, argv, "--seconds", "3"));
+    vector<size_t> batches;
+    stringstream list(argValue(argc, argv, "--batches", "1,16,256"));
+    for (string item; getline(list, item, ','); ) batches.push_back(stoul(item));
+
+    FawryPay fawry;
+    CreditCard card("Bench Fan", "4111111111111111", "123", "12-2030");
+
+    cout << nCheckouts << " concurrent checkouts, " << latencyMs << " ms gateway latency, " << nWorkers << " workers\n";
+    cout << "batch   payments/sec   p50 ms   p99 ms   gateway calls\n";
+    for (size_t maxBatch : batches) {
+        MockGateway gateway{chrono::milliseconds(latencyMs)};
+        vector<double> latencies;
+        mutex latenciesMutex;
+        atomic<int> inFlight{0};
+        atomic<long long> declined{0};
+        auto start = chrono::steady_clock::now();
+        auto deadline = start + chrono::duration<double>(seconds);
+        {
+            PaymentPipeline pipeline(gateway, nWorkers, maxBatch);
+            // one checkout: pay, and when answered record the latency and pay again until the deadline
+            function<void(int)> checkout = [&](int c) {
+                inFlight++;
+                auto sent = chrono::steady_clock::now();
+                pipeline.submit(c % 2 ? (PaymentMethod*)&card : &fawry, Money::pounds(100), [&, c, sent](bool approved) {
+                    auto now = chrono::steady_clock::now();
+                    if (!approved) declined++;
+                    {
+                        lock_guard<mutex> lock(latenciesMutex);
+                        latencies.push_back(chrono::duration<double, milli>(now - sent).count());
+                    }
+                    if (now < deadline) checkout(c);
+                    inFlight--;
+                });
+            };
+            for (int c = 0; c < nCheckouts; ++c) checkout(c);
+            while (inFlight > 0) this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        sort(latencies.begin(), latencies.end());
+        char line[128];
+        snprintf(line, sizeof(line), "%5zu   %12.0f   %6.1f   %6.1f   %13lld", maxBatch, latencies.size() / elapsed,
+                 latencies[latencies.size() / 2], latencies[min(latencies.size() - 1, latencies.size() * 99 / 100)],
+                 gateway.getCalls());
+        cout << line << "\n";
+        if (declined) cout << "  (" << declined << " declined)\n";
+    }
+    return 0;
+}
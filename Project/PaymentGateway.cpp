@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PaymentService.cpp"
+
+using namespace std;
+
+struct PaymentCharge {
+    PaymentMethod* method;
+    Money amount;
+};
+
+// Settlement side of a payment provider, one settle() call is one round trip to it
+class PaymentGateway {
+public:
+    // Settles a batch of one provider's charges, approved[i] answers charges[i]
+    virtual void settle(const string& provider, const vector<PaymentCharge>& charges, vector<bool>& approved) = 0;
+    // Gives back one approved charge, one round trip (refunds are rare, they are not batched)
+    virtual bool refund(const string& provider, const PaymentCharge& charge) = 0;
+    virtual ~PaymentGateway() = default;
+};
+
+// In-process settlement: each charge runs its own strategy's pay(), as PaymentService does
+class DirectGateway : public PaymentGateway {
+public:
+    void settle(const string&, const vector<PaymentCharge>& charges, vector<bool>& approved) override {
+        approved.resize(charges.size());
+        for (size_t i = 0; i < charges.size(); ++i) {
+            approved[i] = charges[i].method->pay(charges[i].amount);
+        }
+    }
+
+    bool refund(const string&, const PaymentCharge& charge) override {
+        return charge.method->refund(charge.amount);
+    }
+};
+
+// Local stand-in for a remote provider: every settle() call waits latency (one round trip, whatever
+// the batch size) and approves every charge with a non-negative amount, except every declineEvery-th
+// charge when declineEvery > 0. Charges are not passed to the strategies, nothing is printed.
+// A refund waits one round trip of its own and is always approved.
+class MockGateway : public PaymentGateway {
+private:
+    chrono::microseconds latency;
+    unsigned declineEvery;
+    atomic<long long> calls{0};
+    atomic<long long> charges{0};
+    atomic<long long> refunds{0};
+
+public:
+    explicit MockGateway(chrono::microseconds latency = chrono::milliseconds(50), unsigned declineEvery = 0)
+        : latency(latency), declineEvery(declineEvery) {}
+
+    void settle(const string&, const vector<PaymentCharge>& batch, vector<bool>& approved) override {
+        this_thread::sleep_for(latency);
+        calls++;
+        approved.resize(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            long long n = ++charges;
+            approved[i] = batch[i].amount >= Money() && (declineEvery == 0 || n % declineEvery != 0);
+        }
+    }
+
+    bool refund(const string&, const PaymentCharge& charge) override {
+        this_thread::sleep_for(latency);
+        refunds++;
+        return charge.amount >= Money();
+    }
+
+    long long getCalls() const { return calls; }
+    long long getCharges() const { return charges; }
+    long long getRefunds() const { return refunds; }
+};
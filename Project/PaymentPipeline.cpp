@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "PaymentGateway.cpp"
+
+using namespace std;
+
+// Asynchronous payments: submit() queues a charge and returns at once, a pool of workers settles
+// the queued charges through the gateway and answers each through its callback (on a worker thread)
+// or its future. Charges are queued per provider, and a worker takes up to maxBatch charges of one
+// provider per settle() call, so while every worker waits on a slow gateway the next batch simply
+// builds up behind them and goes out in one round trip, like the log's group commit.
+//
+// The PaymentMethod passed to submit must stay alive until the charge is answered, unless it is
+// handed over as a unique_ptr. The destructor settles whatever is still queued before returning.
+class PaymentPipeline {
+public:
+    using Done = function<void(bool approved)>;
+
+    explicit PaymentPipeline(PaymentGateway& gateway, unsigned nWorkers = 8, size_t maxBatch = 256)
+        : gateway(gateway), maxBatch(max<size_t>(maxBatch, 1)) {
+        nWorkers = max(nWorkers, 1u);
+        for (unsigned i = 0; i < nWorkers; ++i) {
+            workers.emplace_back([this] { run(); });
+        }
+    }
+
+    ~PaymentPipeline() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (thread& t : workers) t.join();
+    }
+
+    PaymentPipeline(const PaymentPipeline&) = delete;
+    PaymentPipeline& operator=(const PaymentPipeline&) = delete;
+
+    void submit(PaymentMethod* method, Money amount, Done done) {
+        enqueue(Request{method, nullptr, amount, move(done)});
+    }
+
+    void submit(unique_ptr<PaymentMethod> method, Money amount, Done done) {
+        PaymentMethod* raw = method.get();
+        enqueue(Request{raw, shared_ptr<PaymentMethod>(move(method)), amount, move(done)});
+    }
+
+    future<bool> submit(PaymentMethod* method, Money amount) {
+        auto result = make_shared<promise<bool>>();
+        future<bool> pending = result->get_future();
+        submit(method, amount, [result](bool approved) { result->set_value(approved); });
+        return pending;
+    }
+
+    // Refunds an approved charge on the caller's thread, e.g. when its booking failed after payment
+    bool refund(PaymentMethod* method, Money amount) {
+        return gateway.refund(method->provider(), PaymentCharge{method, amount});
+    }
+
+    // Charges waiting for a worker
+    size_t queued() {
+        lock_guard<mutex> lock(queueMutex);
+        return waiting;
+    }
+
+private:
+    struct Request {
+        PaymentMethod* method;
+        shared_ptr<PaymentMethod> owned;
+        Money amount;
+        Done done;
+    };
+
+    PaymentGateway& gateway;
+    size_t maxBatch;
+
+    mutex queueMutex;
+    condition_variable ready;
+    unordered_map<string, deque<Request>> queues;
+    // providers with queued charges, in the order they got them, so no provider starves
+    deque<string> providers;
+    size_t waiting = 0;
+    bool stopping = false;
+    vector<thread> workers;
+
+    void enqueue(Request req) {
+        string provider = req.method->provider();
+        {
+            lock_guard<mutex> lock(queueMutex);
+            deque<Request>& queue = queues[provider];
+            if (queue.empty()) providers.push_back(provider);
+            queue.push_back(move(req));
+            waiting++;
+        }
+        ready.notify_one();
+    }
+
+    void run() {
+        vector<Request> batch;
+        vector<PaymentCharge> charges;
+        vector<bool> approved;
+        while (true) {
+            string provider;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                ready.wait(lock, [this] { return stopping || waiting > 0; });
+                if (waiting == 0) return; // stopping and drained
+
+                provider = providers.front();
+                providers.pop_front();
+                deque<Request>& queue = queues[provider];
+                size_t n = min(queue.size(), maxBatch);
+                for (size_t i = 0; i < n; ++i) {
+                    batch.push_back(move(queue.front()));
+                    queue.pop_front();
+                }
+                waiting -= n;
+                // the rest waits for the next free worker
+                if (!queue.empty()) {
+                    providers.push_back(provider);
+                    ready.notify_one();
+                }
+            }
+
+            charges.clear();
+            for (const Request& req : batch) charges.push_back(PaymentCharge{req.method, req.amount});
+            approved.assign(batch.size(), false);
+            gateway.settle(provider, charges, approved);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                batch[i].done(approved[i]);
+            }
+            batch.clear();
+        }
+    }
+};
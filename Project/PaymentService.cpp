@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "Money.cpp"
+
+using namespace std;
+
+// Payment Strategy Pattern
+
+// Abstract Interface
+class PaymentMethod {
+public:
+    virtual bool pay(Money amount) = 0; // Pure virtual function
+    // Gives back an approved charge whose booking failed
+    virtual bool refund(Money amount) = 0;
+    // Gateway the payment settles through, payments of one provider are settled in batches
+    virtual string provider() const = 0;
+    virtual ~PaymentMethod() = default;
+};
+
+class FawryPay : public PaymentMethod {
+public:
+    // Stateless payment logic
+    bool pay(Money amount) override {
+        cout << "Paying " << amount << " EGP via Fawry.\n";
+        return true;
+    }
+
+    bool refund(Money amount) override {
+        cout << "Refunding " << amount << " EGP via Fawry.\n";
+        return true;
+    }
+
+    string provider() const override { return "fawry"; }
+};
+
+class CreditCard : public PaymentMethod {
+private:
+    string name;
+    string cardNumber;
+    string cvv;
+    string expiryDate;
+
+public:
+    CreditCard(string n, string num, string c, string exp)
+            : name(n), cardNumber(num), cvv(c), expiryDate(exp) {}
+
+    void setName(const string &n) { name = n; }
+
+    void setCardNumber(const string &num) { cardNumber = num; }
+
+    void setCvv(const string &c) { cvv = c; }
+
+    void setExpiryDate(const string &exp) { expiryDate = exp; }
+
+    // Only the last 4 digits are ever printed, pay() runs for HTTP bookings too
+    string maskedNumber() const {
+        size_t shown = min<size_t>(4, cardNumber.size());
+        return string(cardNumber.size() - shown, '*') + cardNumber.substr(cardNumber.size() - shown);
+    }
+
+    bool pay(Money amount) override {
+        cout << "Paying " << amount << " EGP via CreditCard " << maskedNumber() << ".\n";
+        return true;
+    }
+
+    bool refund(Money amount) override {
+        cout << "Refunding " << amount << " EGP to CreditCard " << maskedNumber() << ".\n";
+        return true;
+    }
+
+    string provider() const override { return "card"; }
+};
+
+// Already paid (e.g. at a partner's box office), nothing is charged or printed
+// Also used by the load tools so they measure the service and not the console
+class PrepaidPayment : public PaymentMethod {
+public:
+    bool pay(Money amount) override {
+        return amount >= Money();
+    }
+
+    bool refund(Money amount) override {
+        return amount >= Money();
+    }
+
+    string provider() const override { return "prepaid"; }
+};
+
+class PaymentService {
+private:
+    PaymentMethod *paymentMethod; // Strategy pointer
+
+public:
+    void setPaymentMethod(PaymentMethod *method) {
+        this->paymentMethod = method;
+    }
+
+    bool processPayment(Money amount) {
+        if (paymentMethod) {
+            return paymentMethod->pay(amount);
+        }
+        return false;
+    }
+
+    bool refundPayment(Money amount) {
+        if (paymentMethod) {
+            return paymentMethod->refund(amount);
+        }
+        return false;
+    }
+};
@@ -0,0 +1,94 @@
+// Event name search, the old per-call scan against EventManager::searchByName (trigram index)
+// At 100k and 1M events: the scan lowercases every event's name and the query on each call and
+// runs string::find over all events, like SystemManager::searchEventsByName did; the index looks up
+// the query's trigrams and checks only the candidates. Times --queries rounds of a query mix (a
+// rare word, a common word, a piece of a word, a 2-letter query that falls back to a scan of the
+// folded names) and exits non-zero if the two ever disagree.
+//
+//   ticketak-search-bench [--queries 20]
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EventManager.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// The old searchEventsByName, returning ids instead of the matched events
+static vector<int> scan(EventManager& manager, const string& name) {
+    auto toLower = [](string s) {
+        transform(s.begin(), s.end(), s.begin(), ::tolower);
+        return s;
+    };
+    vector<int> matched;
+    for (Event* event : manager.getEvents()) {
+        if (toLower(event->getName()).find(toLower(name)) != string::npos) matched.push_back(event->getId());
+    }
+    sort(matched.begin(), matched.end());
+    return matched;
+}
+
+int main(int argc, char* argv[]) {
+    const int nQueries = stoi(argValue(argc, argv, "--queries", "20"));
+    const vector<string> first = {"Cairo", "Alexandria", "Giza", "Luxor", "Aswan", "Port Said", "Suez", "Tanta"};
+    const vector<string> second = {"Derby", "Festival", "Carnival", "Cup Final", "Night", "Concert", "Marathon",
+                                   "Expo", "Parade", "Gala"};
+    const vector<string> queries = {"zamalek", "festival", "arniv", "ux"};
+    mt19937 rng(7);
+
+    EventManager& manager = EventManager::getInstance();
+    bool ok = true;
+    int nEvents = 0;
+    cout << "events    query        matches    scan ms/query   index ms/query   speedup\n";
+    for (int target : {100000, 1000000}) {
+        for (; nEvents < target; ++nEvents) {
+            // one event in 10000 is a Zamalek match
+            string name = nEvents % 10000 == 0 ? "Zamalek Derby"
+                        : first[rng() % first.size()] + " " + second[rng() % second.size()];
+            Event event(0, name + " " + to_string(nEvents), Category::Sports, Date{1, 1, 2099},
+                TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 10},
+                TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 10},
+                TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), 10});
+            manager.addEvent(event);
+        }
+        manager.searchByName(queries[0]); // indexes anything still pending
+
+        for (const string& query : queries) {
+            vector<int> expected;
+            auto start = chrono::steady_clock::now();
+            for (int q = 0; q < nQueries; ++q) expected = scan(manager, query);
+            double scanMs = secondsSince(start) * 1e3 / nQueries;
+
+            vector<int> found;
+            start = chrono::steady_clock::now();
+            for (int q = 0; q < nQueries; ++q) found = manager.searchByName(query);
+            double indexMs = secondsSince(start) * 1e3 / nQueries;
+            ok = ok && found == expected;
+
+            char line[160];
+            snprintf(line, sizeof(line), "%7d   %-10s %9zu   %13.3f   %14.3f   %6.1fx", nEvents, query.c_str(),
+                     found.size(), scanMs, indexMs, scanMs / indexMs);
+            cout << line << "\n";
+        }
+    }
+
+    cout << (ok ? "search results match the scan" : "search results DIFFER from the scan") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+// Seat allocation latency on a numbered stadium
+// Builds a 100k seat map (40 sections x 50 rows x 50 seats), sells a random 90% of the seats one by
+// one so the free seats are scattered like a late on-sale, then for each group size times
+// allocate(n) + release of the same seats (occupancy stays put) and reports p50/p99/mean latency.
+// The last line books the remaining seats in pairs until the map is full.
+//
+//   ticketak-seat-bench [--sections 40] [--rows 50] [--seats 50] [--occupancy 0.9] [--trials 200000]
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SeatMap.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+int main(int argc, char* argv[]) {
+    const int nSections = stoi(argValue(argc, argv, "--sections", "40"));
+    const int nRows = stoi(argValue(argc, argv, "--rows", "50"));
+    const int nSeats = stoi(argValue(argc, argv, "--seats", "50"));
+    const double occupancy = stod(argValue(argc, argv, "--occupancy", "0.9"));
+    const int trials = stoi(argValue(argc, argv, "--trials", "200000"));
+
+    SeatMap stadium(SeatLayout::uniform(nSections, nRows, nSeats));
+    vector<Seat> all;
+    for (int s = 0; s < nSections; ++s)
+        for (int r = 0; r < nRows; ++r)
+            for (int n = 0; n < nSeats; ++n) all.push_back(Seat{s, r, n});
+    mt19937 rng(42);
+    shuffle(all.begin(), all.end(), rng);
+    size_t sold = (size_t)(all.size() * occupancy);
+    for (size_t i = 0; i < sold; ++i) {
+        stadium.hold(SeatRange{all[i].section, all[i].row, all[i].number, 1});
+    }
+
+    cout << stadium.capacity() << " seats, " << stadium.available() << " free ("
+         << (int)(100.0 * (stadium.capacity() - stadium.available()) / stadium.capacity() + 0.5) << "% sold)\n";
+    cout << "group   p50 ns   p99 ns   mean ns   found\n";
+    for (int n : {1, 2, 4, 6, 8}) {
+        vector<double> latencies;
+        latencies.reserve(trials);
+        int found = 0;
+        for (int t = 0; t < trials; ++t) {
+            SeatRange held;
+            auto start = chrono::steady_clock::now();
+            bool ok = stadium.allocate(n, held);
+            latencies.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+            if (ok) {
+                found++;
+                stadium.release(held);
+            }
+        }
+        sort(latencies.begin(), latencies.end());
+        double mean = 0;
+        for (double l : latencies) mean += l;
+        mean /= latencies.size();
+        char line[128];
+        snprintf(line, sizeof(line), "%5d   %6.0f   %6.0f   %7.0f   %5.1f%%", n,
+                 latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], mean, 100.0 * found / trials);
+        cout << line << "\n";
+    }
+
+    // Sell the rest in pairs, then singles, as an on-sale would
+    SeatMap rest = stadium;
+    int pairs = 0, singles = 0;
+    SeatRange held;
+    auto start = chrono::steady_clock::now();
+    while (rest.allocate(2, held)) pairs++;
+    while (rest.allocate(1, held)) singles++;
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    cout << "sell-out: " << pairs << " pairs + " << singles << " singles in " << (long long)(ns / 1000) << " us ("
+         << (long long)(ns / (pairs + singles + 2)) << " ns per allocation), " << rest.available() << " seats left\n";
+    return rest.available() == 0 ? 0 : 1;
+}
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Ticket.cpp"
+
+using namespace std;
+
+// Numbered seats of one tier: sections[s][r] = number of seats in row r of section s
+// Sections and rows are listed best first, allocation prefers earlier rows.
+struct SeatLayout {
+    vector<vector<int>> sections;
+
+    static SeatLayout uniform(int nSections, int rowsPerSection, int seatsPerRow) {
+        SeatLayout layout;
+        layout.sections.assign(nSections, vector<int>(rowsPerSection, seatsPerRow));
+        return layout;
+    }
+
+    int seatCount() const {
+        int total = 0;
+        for (const vector<int>& rows : sections) {
+            for (int seats : rows) total += seats;
+        }
+        return total;
+    }
+
+    bool empty() const { return seatCount() == 0; }
+};
+
+// count adjacent seats of one row, starting at seat number
+struct SeatRange {
+    int section = -1;
+    int row = -1;
+    int number = -1;
+    int count = 0;
+
+    Seat seat(int i) const { return Seat{section, row, number + i}; }
+};
+
+// Seat inventory of one tier as a bitmap, one bit per seat (1 = held or sold), each row starting
+// on its own 64-bit word so a run of free seats never spans two rows.
+//
+// allocate(n) finds the best n adjacent free seats with word-level bit scans: a run inside a word
+// is found with a few shift-and steps, a run across words by carrying the free bits at the top of
+// each word. Rows whose free count is below n are skipped at once, rows in front of openFrom are
+// full and never looked at, and a row that failed a scan for n remembers that it has no run of n
+// until seats in it are released, so each row is scanned in full at most once between releases.
+// A size that found no run anywhere is refused at once until the next release.
+//
+// Holds are atomic: every word of a range is claimed with compare-and-swap, and a range that meets
+// a taken seat is rolled back and fails, so concurrent holders never share a seat.
+class SeatMap {
+private:
+    struct RowInfo {
+        int section;
+        int row;
+        int seats;
+        size_t firstWord;
+    };
+
+    SeatLayout layout;
+    vector<RowInfo> rows;
+    vector<size_t> sectionFirstRow;
+    size_t nWords = 0;
+    unique_ptr<atomic<uint64_t>[]> words;
+    unique_ptr<atomic<int>[]> freeSeats;
+    // per row: [release count : 32][upper bound of the longest free run : 32]
+    unique_ptr<atomic<uint64_t>[]> runHint;
+    // rows before it have no free seat
+    atomic<size_t> openFrom{0};
+    // same as runHint for the whole map, a size that failed everywhere fails at once until a release
+    atomic<uint64_t> mapHint{0};
+    int longestRow = 0;
+
+    static int trailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return (int)i;
+#else
+        return __builtin_ctzll(x);
+#endif
+    }
+
+    static int leadingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanReverse64(&i, x);
+        return 63 - (int)i;
+#else
+        return __builtin_clzll(x);
+#endif
+    }
+
+    // Bits [from, to) of one word, 0 <= from < to <= 64
+    static uint64_t bitRange(int from, int to) {
+        uint64_t high = to == 64 ? ~0ull : (1ull << to) - 1;
+        return high & ~((1ull << from) - 1);
+    }
+
+    static uint64_t packHint(uint64_t releases, int longestRun) {
+        return (releases << 32) | (uint32_t)longestRun;
+    }
+
+    void build(const SeatLayout& source) {
+        layout = source;
+        rows.clear();
+        sectionFirstRow.clear();
+        nWords = 0;
+        longestRow = 0;
+        for (size_t s = 0; s < layout.sections.size(); ++s) {
+            sectionFirstRow.push_back(rows.size());
+            for (size_t r = 0; r < layout.sections[s].size(); ++r) {
+                int seats = max(layout.sections[s][r], 0);
+                rows.push_back(RowInfo{(int)s, (int)r, seats, nWords});
+                longestRow = max(longestRow, seats);
+                nWords += (seats + 63) / 64;
+            }
+        }
+        words.reset(new atomic<uint64_t>[nWords]);
+        freeSeats.reset(new atomic<int>[rows.size()]);
+        runHint.reset(new atomic<uint64_t>[rows.size()]);
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const RowInfo& row = rows[i];
+            size_t rowWords = (row.seats + 63) / 64;
+            for (size_t w = 0; w < rowWords; ++w) words[row.firstWord + w] = 0;
+            // bits past the last seat stay taken so scans never hand them out
+            if (row.seats % 64) words[row.firstWord + rowWords - 1] = ~bitRange(0, row.seats % 64);
+            freeSeats[i] = row.seats;
+            runHint[i] = packHint(0, row.seats);
+        }
+        openFrom = 0;
+        mapHint = packHint(0, longestRow);
+    }
+
+    // Index of the range's row, or -1 when the range is not inside the layout
+    long rowIndex(const SeatRange& range) const {
+        if (range.section < 0 || range.section >= (int)layout.sections.size()) return -1;
+        const vector<int>& sectionRows = layout.sections[range.section];
+        if (range.row < 0 || range.row >= (int)sectionRows.size()) return -1;
+        long index = (long)(sectionFirstRow[range.section] + range.row);
+        if (range.count <= 0 || range.number < 0 || range.number + range.count > rows[index].seats) return -1;
+        return index;
+    }
+
+    // First seat of a run of n free seats in the row, or -1
+    int findRun(const RowInfo& row, int n) const {
+        size_t rowWords = (row.seats + 63) / 64;
+        int run = 0, runStart = 0;
+        for (size_t k = 0; k < rowWords; ++k) {
+            int base = (int)k * 64;
+            uint64_t taken = words[row.firstWord + k].load();
+            if (taken == 0) {
+                if (run == 0) runStart = base;
+                run += 64;
+                if (run >= n) return runStart;
+                continue;
+            }
+            // run carried in from the previous words, ended by this word's free low bits
+            int low = trailingZeros(taken);
+            if (run == 0) runStart = base;
+            if (run + low >= n) return runStart;
+            // run inside this word: bit i of free survives only if bits i..i+n-1 are all free
+            if (n <= 64) {
+                uint64_t free = ~taken;
+                for (int have = 1; have < n && free; ) {
+                    int shift = min(have, n - have);
+                    free &= free >> shift;
+                    have += shift;
+                }
+                if (free) return base + trailingZeros(free);
+            }
+            run = leadingZeros(taken);
+            runStart = base + 64 - run;
+        }
+        return -1;
+    }
+
+    // Claims the bits of the range, false (and nothing claimed) if any of them is taken
+    bool claim(const RowInfo& row, const SeatRange& range) {
+        int first = range.number, last = range.number + range.count; // [first, last)
+        for (int pos = first; pos < last; ) {
+            size_t k = pos / 64;
+            int to = min(last - (int)k * 64, 64);
+            uint64_t mask = bitRange(pos % 64, to);
+            atomic<uint64_t>& word = words[row.firstWord + k];
+            uint64_t current = word.load();
+            do {
+                if (current & mask) {
+                    unclaim(row, SeatRange{range.section, range.row, first, pos - first});
+                    return false;
+                }
+            } while (!word.compare_exchange_weak(current, current | mask));
+            pos = (int)k * 64 + to;
+        }
+        return true;
+    }
+
+    void unclaim(const RowInfo& row, const SeatRange& range) {
+        int last = range.number + range.count;
+        for (int pos = range.number; pos < last; ) {
+            size_t k = pos / 64;
+            int to = min(last - (int)k * 64, 64);
+            words[row.firstWord + k].fetch_and(~bitRange(pos % 64, to));
+            pos = (int)k * 64 + to;
+        }
+    }
+
+    void lowerOpenFrom(size_t index) {
+        size_t current = openFrom.load();
+        while (current > index && !openFrom.compare_exchange_weak(current, index)) {}
+    }
+
+public:
+    SeatMap() = default;
+
+    explicit SeatMap(const SeatLayout& layout) { build(layout); }
+
+    // atomics are not copyable, copy the current bitmap
+    SeatMap(const SeatMap& other) { *this = other; }
+
+    SeatMap& operator=(const SeatMap& other) {
+        if (this == &other) return *this;
+        build(other.layout);
+        for (size_t i = 0; i < nWords; ++i) words[i] = other.words[i].load();
+        for (size_t i = 0; i < rows.size(); ++i) {
+            freeSeats[i] = other.freeSeats[i].load();
+            runHint[i] = other.runHint[i].load();
+        }
+        openFrom = other.openFrom.load();
+        mapHint = other.mapHint.load();
+        return *this;
+    }
+
+    const SeatLayout& getLayout() const { return layout; }
+
+    int capacity() const { return layout.seatCount(); }
+
+    int available() const {
+        int total = 0;
+        for (size_t i = 0; i < rows.size(); ++i) total += freeSeats[i].load();
+        return total;
+    }
+
+    bool isTaken(const Seat& seat) const {
+        long index = rowIndex(SeatRange{seat.section, seat.row, seat.number, 1});
+        if (index < 0) return false;
+        uint64_t word = words[rows[index].firstWord + seat.number / 64].load();
+        return (word >> (seat.number % 64)) & 1;
+    }
+
+    // Holds the given seats, false if any of them is taken or outside the layout
+    bool hold(const SeatRange& range) {
+        long index = rowIndex(range);
+        if (index < 0 || freeSeats[index].load() < range.count) return false;
+        if (!claim(rows[index], range)) return false;
+        freeSeats[index] -= range.count;
+        return true;
+    }
+
+    // Gives held or sold seats back
+    void release(const SeatRange& range) {
+        long index = rowIndex(range);
+        if (index < 0) return;
+        unclaim(rows[index], range);
+        freeSeats[index] += range.count;
+        // the row may have a longer run now, forget what failed scans learned
+        uint64_t hint = runHint[index].load();
+        while (!runHint[index].compare_exchange_weak(hint, packHint((hint >> 32) + 1, rows[index].seats))) {}
+        hint = mapHint.load();
+        while (!mapHint.compare_exchange_weak(hint, packHint((hint >> 32) + 1, longestRow))) {}
+        lowerOpenFrom(index);
+    }
+
+    // Holds the best n adjacent free seats: the first row (in layout order) with such a run, leftmost run in it
+    bool allocate(int n, SeatRange& held) {
+        uint64_t mapBound = mapHint.load();
+        if (n <= 0 || (int)(uint32_t)mapBound < n) return false;
+        for (size_t i = openFrom.load(); i < rows.size(); ++i) {
+            int free = freeSeats[i].load();
+            if (free == 0) {
+                size_t expected = i;
+                // a release racing with the advance sees the new openFrom or leaves a free seat to see here
+                if (openFrom.compare_exchange_strong(expected, i + 1) && freeSeats[i].load() > 0)
+                    lowerOpenFrom(i);
+                continue;
+            }
+            if (free < n) continue;
+            uint64_t hint = runHint[i].load();
+            if ((int)(uint32_t)hint < n) continue;
+
+            const RowInfo& row = rows[i];
+            int start = findRun(row, n);
+            if (start < 0) {
+                // no run of n until the next release, unless one happened during the scan
+                runHint[i].compare_exchange_strong(hint, packHint(hint >> 32, n - 1));
+                continue;
+            }
+            SeatRange range{row.section, row.row, start, n};
+            if (hold(range)) {
+                held = range;
+                return true;
+            }
+            --i; // lost the seats to another holder, scan the row again
+        }
+        mapHint.compare_exchange_strong(mapBound, packHint(mapBound >> 32, n - 1));
+        return false;
+    }
+};
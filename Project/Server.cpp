@@ -0,0 +1,58 @@
+// Ticketak HTTP server: the booking service over HTTP/1.1 + JSON (see TicketakHttpApi.cpp for the endpoints)
+//
+//   ticketak-server [--host 0.0.0.0] [--port 8080] [--workers N] [--data DIR]
+// Loads DIR/events.catalog and the stored managers like the console application, Ctrl+C stops it.
+
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "HttpServer.cpp"
+#include "TicketakHttpApi.cpp"
+
+using namespace std;
+
+static HttpServer* runningServer = nullptr;
+
+static void onSignal(int) {
+    if (runningServer) runningServer->stop();
+}
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+int main(int argc, char* argv[]) {
+    const string host = argValue(argc, argv, "--host", "0.0.0.0");
+    const int port = stoi(argValue(argc, argv, "--port", "8080"));
+    const int workers = stoi(argValue(argc, argv, "--workers", to_string(max(1u, thread::hardware_concurrency()))));
+    const string dataDir = argValue(argc, argv, "--data", "data");
+
+    EventManager::getInstance().attachCatalog(dataDir + "/events.catalog");
+    StorageManager& storage = StorageManager::getInstance();
+    if (!storage.open(dataDir))
+        cout << "Warning: stored data could not be fully loaded\n";
+
+    TicketakHttpApi api;
+    HttpServer server([&api](const HttpRequest& req) { return api.handle(req); }, workers);
+    if (!server.listen(host, port)) {
+        cout << "Could not listen on " << host << ":" << port << "\n";
+        return 1;
+    }
+
+    runningServer = &server;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    cout << "Ticketak listening on " << host << ":" << server.port() << " with " << workers << " workers\n";
+    server.run();
+    runningServer = nullptr;
+
+    // Fold the log into a fresh snapshot so the next start only loads the snapshot
+    TicketakService::getInstance().checkpoint();
+    storage.close();
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Startup time and write amplification of the snapshot + write-ahead log, at 10M tickets
+// Books --tickets tickets over --events events and checkpoints them (one snapshot), then books
+// --logged more from --threads threads that each log their booking with logBookEvent, so the
+// records share fsyncs through the group commit. Then it checkpoints again while those threads keep
+// booking, each booking inside a ChangeGuard as TicketakService does. The program then runs itself
+// again with --load: a fresh process that times StorageManager::open (snapshot load + log replay) and
+// exits non-zero unless every ticket came back exactly once.
+// Write amplification is the bytes that reach the disk per booking: one log record, against the
+// whole snapshot that saving the managers after every change would rewrite.
+//
+//   ticketak-storage-bench [--tickets 10000000] [--events 100] [--logged 20000] [--threads 16] [--dir PATH]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StorageManager.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// The --load half: recover from dir in this fresh process and count what came back
+static int load(const string& dir, size_t expected) {
+    auto start = chrono::steady_clock::now();
+    bool ok = StorageManager::getInstance().open(dir);
+    double seconds = secondsSince(start);
+    size_t booked = 0;
+    for (const Event* e : static_cast<const EventManager&>(EventManager::getInstance()).getEvents())
+        booked += e->getTicketCount();
+    StorageManager::getInstance().close();
+
+    char line[160];
+    snprintf(line, sizeof(line), "startup      %8.2f s  (%zu tickets recovered, %.0f tickets/s)", seconds, booked,
+             booked / seconds);
+    cout << line << endl;
+    return ok && booked == expected ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    const string dir = argValue(argc, argv, "--dir",
+                                (filesystem::temp_directory_path() / "ticketak-storage-bench").string());
+    if (argValue(argc, argv, "--load", "").size() > 0)
+        return load(dir, stoull(argValue(argc, argv, "--load", "0")));
+
+    const int nTickets = stoi(argValue(argc, argv, "--tickets", "10000000"));
+    const int nEvents = stoi(argValue(argc, argv, "--events", "100"));
+    const int nLogged = stoi(argValue(argc, argv, "--logged", "20000"));
+    const int nThreads = stoi(argValue(argc, argv, "--threads", "16"));
+    error_code ec;
+    filesystem::remove_all(dir, ec);
+
+    StorageManager& storage = StorageManager::getInstance();
+    if (!storage.open(dir)) {
+        cout << "cannot open " << dir << endl;
+        return 1;
+    }
+
+    EventManager& eventManager = EventManager::getInstance();
+    vector<int> ids;
+    const int perEvent = nTickets / nEvents + 1;
+    for (int i = 0; i < nEvents; ++i) {
+        Event event(0, "Event " + to_string(i), Category::Sports, Date{1, 1, 2099},
+            TicketTypePriceQuantity{TicketType::VIP, Money::pounds(500), 0},
+            TicketTypePriceQuantity{TicketType::Economic, Money::pounds(200), 0},
+            TicketTypePriceQuantity{TicketType::Regular, Money::pounds(100), perEvent + 2 * nLogged});
+        eventManager.addEvent(event);
+        ids.push_back(event.getId());
+    }
+    const TicketTypePrice regular{TicketType::Regular, Money::pounds(100)};
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < nTickets; ++i) eventManager.getEvent(ids[i % nEvents])->bookEvent(i % 1000 + 1, regular);
+    double bookSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    bool ok = storage.checkpoint();
+    double snapshotSeconds = secondsSince(start);
+    uintmax_t snapshotBytes = filesystem::file_size(dir + "/ticketak.snap", ec);
+
+    // logged bookings, like TicketakService: book, then wait for the record to be durable
+    atomic<int> next{0};
+    atomic<bool> logged{true};
+    start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = next++; i < nLogged; i = next++) {
+                StorageManager::ChangeGuard change(storage);
+                Ticket ticket = eventManager.getEvent(ids[i % nEvents])->bookEvent(i % 1000 + 1, regular);
+                if (!ticket.isValid() || !storage.logBookEvent(ticket)) logged = false;
+            }
+        });
+    }
+    for (thread& t : threads) t.join();
+    double logSeconds = secondsSince(start);
+    uintmax_t logBytes = filesystem::file_size(dir + "/ticketak.wal", ec);
+
+    // a checkpoint cut between running bookings: none may end up in both the snapshot and the log
+    atomic<bool> cutDone{false};
+    atomic<int> cutBooked{0};
+    threads.clear();
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = t, after = 0; after < 100; i += nThreads) {
+                if (cutDone) after++;
+                StorageManager::ChangeGuard change(storage);
+                Ticket ticket = eventManager.getEvent(ids[i % nEvents])->bookEvent(i % 1000 + 1, regular);
+                if (!ticket.isValid() || !storage.logBookEvent(ticket)) logged = false;
+                cutBooked++;
+            }
+        });
+    }
+    start = chrono::steady_clock::now();
+    ok = storage.checkpoint() && ok;
+    double cutSeconds = secondsSince(start);
+    cutDone = true;
+    for (thread& t : threads) t.join();
+    storage.close();
+    ok = ok && logged;
+
+    char line[200];
+    snprintf(line, sizeof(line), "booked       %8.2f s  (%d tickets over %d events)", bookSeconds, nTickets, nEvents);
+    cout << line << endl;
+    snprintf(line, sizeof(line), "snapshot     %8.2f s  %10.1f MB  (%.1f B/ticket)", snapshotSeconds,
+             snapshotBytes / 1048576.0, (double)snapshotBytes / nTickets);
+    cout << line << endl;
+    snprintf(line, sizeof(line), "logged       %8.2f s  %10.0f bookings/s from %d threads, group commit",
+             logSeconds, nLogged / logSeconds, nThreads);
+    cout << line << endl;
+    snprintf(line, sizeof(line), "written per booking: log %.0f B, snapshot rewrite %.1f MB (%.0fx more)",
+             (double)logBytes / nLogged, snapshotBytes / 1048576.0, (double)snapshotBytes * nLogged / logBytes);
+    cout << line << endl;
+    snprintf(line, sizeof(line), "checkpoint   %8.2f s  under load, %d bookings around it", cutSeconds, (int)cutBooked);
+    cout << line << endl;
+
+    // recovery in a fresh process, so nothing is already in memory
+    size_t expected = (size_t)nTickets + nLogged + cutBooked;
+    string command = "\"" + string(argv[0]) + "\" --dir \"" + dir + "\" --load " + to_string(expected);
+    ok = system(command.c_str()) == 0 && ok;
+    filesystem::remove_all(dir, ec);
+
+    cout << (ok ? "storage checks passed" : "storage checks FAILED") << endl;
+    return ok ? 0 : 1;
+}
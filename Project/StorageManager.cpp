@@ -0,0 +1,754 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>     // _commit, _fileno
+#else
+#include <unistd.h> // fsync, fileno
+#endif
+
+#include "EventManager.cpp"
+#include "FanManager.cpp"
+#include "AdminManager.cpp"
+
+using namespace std;
+
+// Operations recorded in the write-ahead log
+enum class LogOp : uint8_t {
+    AddEvent = 1,
+    EditEvent = 2,
+    DeleteEvent = 3,
+    BookEvent = 4,
+    AddFan = 5,
+    SetSeatMap = 6
+};
+
+// Appends fixed-size values and length-prefixed strings to a byte buffer
+// Note: values are written in the machine's native byte order
+class BinaryWriter {
+private:
+    vector<char>& buf;
+
+public:
+    explicit BinaryWriter(vector<char>& buf) : buf(buf) {}
+
+    template <typename T>
+    void put(T value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+
+    void putString(const string& s) {
+        put<uint32_t>(s.size());
+        buf.insert(buf.end(), s.begin(), s.end());
+    }
+};
+
+// Reads what BinaryWriter wrote, every read fails (returns false) instead of running past the end
+class BinaryReader {
+private:
+    const char* pos;
+    const char* end;
+
+public:
+    BinaryReader(const char* data, size_t size) : pos(data), end(data + size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if ((size_t)(end - pos) < sizeof(T)) return false;
+        memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool getString(string& s) {
+        uint32_t n;
+        if (!get(n) || (size_t)(end - pos) < n) return false;
+        s.assign(pos, n);
+        pos += n;
+        return true;
+    }
+
+    bool atEnd() const { return pos == end; }
+};
+
+// Singleton Class for durable storage of the Event, Fan and Admin managers
+// Layout on disk (inside the data directory):
+//   ticketak.snap : full binary snapshot of all managers, replaced atomically by checkpoint()
+//   ticketak.wal  : write-ahead log of the operations done after the last snapshot, behind a header
+//                   naming its format version
+// Recovery = load the snapshot then replay the log, a torn record at the end of the log
+// (crash in the middle of a write) is dropped.
+class StorageManager {
+private:
+    static constexpr char SNAPSHOT_MAGIC[8] = {'T', 'K', 'S', 'N', 'A', 'P', '0', '1'};
+    // Tickets (the TicketStore), admins, fans and events with the ids of their tickets, seat layouts,
+    // deleted catalog event ids, every price in piastres. Only this version is read.
+    static constexpr uint32_t SNAPSHOT_VERSION = 5;
+    static constexpr char LOG_MAGIC[8] = {'T', 'K', 'W', 'A', 'L', 'O', 'G', '1'};
+    // Records with prices in piastres (the headerless log before it was version 1). Only this version is read.
+    static constexpr uint32_t LOG_VERSION = 2;
+    static constexpr size_t LOG_HEADER_SIZE = sizeof(LOG_MAGIC) + sizeof(uint32_t);
+
+    string snapshotPath;
+    string logPath;
+    FILE* logFile = nullptr;
+
+    // Group commit: records appended while another thread is syncing the log
+    // wait in pending and are made durable together by the next single fsync
+    mutex logMutex;
+    condition_variable logSynced;
+    vector<char> pending;
+    uint64_t appendedSeq = 0;
+    uint64_t durableSeq = 0;
+    bool syncing = false;
+    bool lastSyncOk = true;
+
+    // Consistent cut for checkpoint(): the changes holding a ChangeGuard, and whether a checkpoint
+    // is holding new ones back
+    mutex cutMutex;
+    condition_variable cutChanged;
+    int changesRunning = 0;
+    bool cutting = false;
+
+    // Private constructor
+    StorageManager() = default;
+
+    // Disable copy & assignment
+    StorageManager(const StorageManager&) = delete;
+    StorageManager& operator=(const StorageManager&) = delete;
+
+    // FNV-1a, used to detect torn or corrupted records
+    static uint32_t checksum(const char* data, size_t size) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= (unsigned char)data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static bool syncFile(FILE* f) {
+        if (fflush(f) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(f)) == 0;
+#else
+        return fsync(fileno(f)) == 0;
+#endif
+    }
+
+    static bool readFile(const string& path, vector<char>& data) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (f == nullptr) return false;
+        char chunk[1 << 16];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            data.insert(data.end(), chunk, chunk + n);
+        }
+        fclose(f);
+        return true;
+    }
+
+    // ---------- Records ----------
+
+    static void writeUser(BinaryWriter& w, const User& u) {
+        w.putString(u.getName());
+        w.putString(u.getEmail());
+        w.putString(u.getPassword());
+        w.put<char>(u.getGender());
+        w.putString(u.getPhoneNumber());
+    }
+
+    static bool readUser(BinaryReader& r, User& u) {
+        string name, email, password, phone;
+        char gender;
+        if (!r.getString(name) || !r.getString(email) || !r.getString(password) ||
+            !r.get(gender) || !r.getString(phone))
+            return false;
+        u.setName(name);
+        u.setEmail(email);
+        u.setPassword(password);
+        u.setGender(gender);
+        u.setPhoneNumber(phone);
+        return true;
+    }
+
+    // The packed record: id (holds the event id), fan, tier, status, price in piastres, 16-bit seat
+    static void writeTicket(BinaryWriter& w, const Ticket& t) {
+        Seat seat = t.getSeat();
+        w.put<uint64_t>(t.getId());
+        w.put<int32_t>(t.getFanId());
+        w.put<uint8_t>((uint8_t)t.getTypePrice().type);
+        w.put<uint8_t>((uint8_t)t.getTicketStatus());
+        w.put<int64_t>(t.getPrice().piastres());
+        w.put<int16_t>((int16_t)seat.section);
+        w.put<int16_t>((int16_t)seat.row);
+        w.put<int16_t>((int16_t)seat.number);
+    }
+
+    static bool readTicket(BinaryReader& r, Ticket& t) {
+        uint64_t id;
+        int32_t fanId;
+        uint8_t type, status;
+        int64_t price;
+        int16_t section, row, number;
+        if (!r.get(id) || !r.get(fanId) || !r.get(type) || !r.get(status) || !r.get(price) ||
+            !r.get(section) || !r.get(row) || !r.get(number))
+            return false;
+        t = Ticket((int)(id >> 32), fanId, TicketTypePrice{(TicketType)type, Money::fromPiastres(price)});
+        t.setId(id);
+        t.setTicketStatus((TicketStatus)status);
+        t.setSeat(Seat{section, row, number});
+        return true;
+    }
+
+    static void writeTicketIds(BinaryWriter& w, const vector<uint64_t>& ids) {
+        w.put<uint32_t>(ids.size());
+        for (uint64_t id : ids) w.put<uint64_t>(id);
+    }
+
+    static void writeSeat(BinaryWriter& w, const Seat& seat) {
+        w.put<int32_t>(seat.section);
+        w.put<int32_t>(seat.row);
+        w.put<int32_t>(seat.number);
+    }
+
+    static bool readSeat(BinaryReader& r, Seat& seat) {
+        int32_t section, row, number;
+        if (!r.get(section) || !r.get(row) || !r.get(number)) return false;
+        seat = Seat{section, row, number};
+        return true;
+    }
+
+    // Rows per section then seats per row, no sections = general admission
+    static void writeLayout(BinaryWriter& w, const SeatMap* seats) {
+        if (seats == nullptr) {
+            w.put<uint32_t>(0);
+            return;
+        }
+        const SeatLayout& layout = seats->getLayout();
+        w.put<uint32_t>(layout.sections.size());
+        for (const vector<int>& rows : layout.sections) {
+            w.put<uint32_t>(rows.size());
+            for (int seatCount : rows) w.put<int32_t>(seatCount);
+        }
+    }
+
+    static bool readLayout(BinaryReader& r, SeatLayout& layout) {
+        uint32_t nSections, nRows;
+        if (!r.get(nSections)) return false;
+        layout.sections.assign(nSections, {});
+        for (vector<int>& rows : layout.sections) {
+            if (!r.get(nRows)) return false;
+            rows.resize(nRows);
+            for (int& seatCount : rows) {
+                int32_t value;
+                if (!r.get(value)) return false;
+                seatCount = value;
+            }
+        }
+        return true;
+    }
+
+    // Gives a restored event its seat layouts, keeping the stored quantities (the sold seats
+    // are marked by the event's tickets, added afterwards)
+    static bool readEventSeats(BinaryReader& r, Event& e) {
+        int capacity = e.getCapacity();
+        for (TicketType type : {TicketType::VIP, TicketType::Economic, TicketType::Regular}) {
+            SeatLayout layout;
+            if (!readLayout(r, layout)) return false;
+            if (layout.empty()) continue;
+            int quantity = type == TicketType::VIP ? e.getVipTickets().quantity
+                : type == TicketType::Economic ? e.getEconomicTickets().quantity : e.getRegularTickets().quantity;
+            e.setSeatMap(type, layout);
+            e.setTicketQuantity(type, quantity);
+        }
+        e.setCapacity(capacity);
+        return true;
+    }
+
+    // Held tickets are stored as unsold, holds do not survive a restart
+    static void writeTier(BinaryWriter& w, const TicketTypePriceQuantity& tier, int held) {
+        w.put<int64_t>(tier.price.piastres());
+        w.put<int32_t>(tier.quantity + held);
+    }
+
+    static bool readTier(BinaryReader& r, TicketType type, TicketTypePriceQuantity& tier) {
+        int32_t quantity;
+        int64_t price;
+        tier.type = type;
+        if (!r.get(price) || !r.get(quantity)) return false;
+        tier.price = Money::fromPiastres(price);
+        tier.quantity = quantity;
+        return true;
+    }
+
+    // Event fields without its tickets
+    static void writeEventCore(BinaryWriter& w, const Event& e) {
+        w.put<int32_t>(e.getId());
+        w.putString(e.getName());
+        w.put<int32_t>((int32_t)e.getCategory());
+        w.put<int32_t>(e.getDay());
+        w.put<int32_t>(e.getMonth());
+        w.put<int32_t>(e.getYear());
+        writeTier(w, e.getVipTickets(), e.getHeldTickets(TicketType::VIP));
+        writeTier(w, e.getEconomicTickets(), e.getHeldTickets(TicketType::Economic));
+        writeTier(w, e.getRegularTickets(), e.getHeldTickets(TicketType::Regular));
+        w.put<int32_t>(e.getCapacity());
+    }
+
+    static bool readEventCore(BinaryReader& r, Event& e) {
+        int32_t id, category, day, month, year, capacity;
+        string name;
+        TicketTypePriceQuantity vip, economic, regular;
+        if (!r.get(id) || !r.getString(name) || !r.get(category) ||
+            !r.get(day) || !r.get(month) || !r.get(year) ||
+            !readTier(r, TicketType::VIP, vip) ||
+            !readTier(r, TicketType::Economic, economic) ||
+            !readTier(r, TicketType::Regular, regular) ||
+            !r.get(capacity))
+            return false;
+        e = Event(id, name, (Category)category, Date{day, month, year}, vip, economic, regular);
+        e.setCapacity(capacity);
+        return true;
+    }
+
+    // ---------- Snapshot ----------
+
+    bool loadSnapshot() {
+        vector<char> data;
+        if (!readFile(snapshotPath, data)) return true; // no snapshot yet
+
+        const size_t headerSize = sizeof(SNAPSHOT_MAGIC) + sizeof(uint32_t);
+        if (data.size() < headerSize + sizeof(uint32_t) ||
+            memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+            return false;
+
+        size_t bodySize = data.size() - sizeof(uint32_t);
+        uint32_t storedSum;
+        memcpy(&storedSum, data.data() + bodySize, sizeof(storedSum));
+        if (storedSum != checksum(data.data(), bodySize)) return false;
+
+        BinaryReader r(data.data() + sizeof(SNAPSHOT_MAGIC), bodySize - sizeof(SNAPSHOT_MAGIC));
+        uint32_t version, count;
+        if (!r.get(version) || version != SNAPSHOT_VERSION) return false;
+
+        TicketStore& ticketStore = TicketStore::getInstance();
+        if (!r.get(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            Ticket t;
+            if (!readTicket(r, t) || !ticketStore.restore(t)) return false;
+        }
+
+        AdminManager& adminManager = AdminManager::getInstance();
+        if (!r.get(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            Admin admin;
+            if (!readUser(r, admin)) return false;
+            adminManager.addAdmin(admin);
+        }
+
+        FanManager& fanManager = FanManager::getInstance();
+        if (!r.get(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            Fan fan;
+            int32_t id;
+            uint32_t nTickets;
+            if (!readUser(r, fan) || !r.get(id) || !r.get(nTickets)) return false;
+            fan.setId(id);
+            for (uint32_t j = 0; j < nTickets; ++j) {
+                uint64_t ticketId;
+                if (!r.get(ticketId)) return false;
+                fan.buyTicket(ticketId);
+            }
+            fanManager.addFan(fan);
+        }
+
+        EventManager& eventManager = EventManager::getInstance();
+        if (!r.get(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            Event event;
+            uint32_t nTickets;
+            if (!readEventCore(r, event) || !readEventSeats(r, event) || !r.get(nTickets))
+                return false;
+            for (uint32_t j = 0; j < nTickets; ++j) {
+                Ticket t;
+                uint64_t ticketId;
+                if (!r.get(ticketId) || !ticketStore.get(ticketId, t) || !event.addTicket(t)) return false;
+            }
+            eventManager.addEvent(event);
+        }
+
+        if (!r.get(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            int32_t id;
+            if (!r.get(id)) return false;
+            eventManager.deleteEvent(id);
+        }
+        return r.atEnd();
+    }
+
+    bool writeSnapshot() {
+        vector<char> data(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + sizeof(SNAPSHOT_MAGIC));
+        BinaryWriter w(data);
+        w.put<uint32_t>(SNAPSHOT_VERSION);
+
+        // ticket count goes in front of the tickets, known once they are written
+        size_t countAt = data.size();
+        uint32_t nTickets = 0;
+        w.put<uint32_t>(0);
+        TicketStore::getInstance().forEach([&](const Ticket& t) {
+            writeTicket(w, t);
+            nTickets++;
+        });
+        memcpy(data.data() + countAt, &nTickets, sizeof(nTickets));
+
+        const auto& admins = AdminManager::getInstance().getAdmins();
+        w.put<uint32_t>(admins.size());
+        for (const Admin& admin : admins) {
+            writeUser(w, admin);
+        }
+
+        const auto& fans = FanManager::getInstance().getFans();
+        w.put<uint32_t>(fans.size());
+        for (const Fan& fan : fans) {
+            writeUser(w, fan);
+            w.put<int32_t>(fan.getId());
+            writeTicketIds(w, fan.getMyTicketIds());
+        }
+
+        vector<const Event*> events = static_cast<const EventManager&>(EventManager::getInstance()).getEvents();
+        w.put<uint32_t>(events.size());
+        for (const Event* e : events) {
+            writeEventCore(w, *e);
+            for (TicketType type : {TicketType::VIP, TicketType::Economic, TicketType::Regular}) {
+                writeLayout(w, e->getSeatMap(type));
+            }
+            writeTicketIds(w, e->getTicketIds());
+        }
+
+        // Catalog events only live in the read-only catalog file, remember which were deleted
+        vector<int> deletedIds = EventManager::getInstance().getDeletedCatalogIds();
+        w.put<uint32_t>(deletedIds.size());
+        for (int id : deletedIds) {
+            w.put<int32_t>(id);
+        }
+        w.put<uint32_t>(checksum(data.data(), data.size()));
+
+        // Write next to the old snapshot then rename over it, so a crash never leaves a half snapshot
+        string tmpPath = snapshotPath + ".tmp";
+        FILE* f = fopen(tmpPath.c_str(), "wb");
+        if (f == nullptr) return false;
+        bool ok = fwrite(data.data(), 1, data.size(), f) == data.size() && syncFile(f);
+        fclose(f);
+        if (!ok) return false;
+
+        error_code ec;
+        filesystem::rename(tmpPath, snapshotPath, ec);
+        return !ec;
+    }
+
+    // Snapshot, then a new empty log
+    bool rotate() {
+        unique_lock<mutex> lock(logMutex);
+        // a group commit leader writes to logFile outside the lock
+        logSynced.wait(lock, [this] { return !syncing; });
+        if (!writeSnapshot()) return false;
+        // records not written yet are in the snapshot, the new log must not replay them again;
+        // their committers are told they are durable
+        pending.clear();
+        durableSeq = appendedSeq;
+        lastSyncOk = true;
+        logSynced.notify_all();
+        if (logFile) fclose(logFile);
+        logFile = fopen(logPath.c_str(), "wb");
+        return logFile != nullptr && writeLogHeader();
+    }
+
+    // ---------- Write-ahead log ----------
+
+    // Re-applies one logged operation to the managers
+    bool replay(LogOp op, BinaryReader& r) {
+        EventManager& eventManager = EventManager::getInstance();
+        switch (op) {
+            case LogOp::AddEvent: {
+                Event event;
+                if (!readEventCore(r, event)) return false;
+                eventManager.addEvent(event);
+                return true;
+            }
+            case LogOp::EditEvent: {
+                Event edited;
+                if (!readEventCore(r, edited)) return false;
+                Event* e = eventManager.getEvent(edited.getId());
+                if (e == nullptr) return true;
+                e->applyEdit(edited);
+                eventManager.reindexEvent(*e);
+                return true;
+            }
+            case LogOp::DeleteEvent: {
+                int32_t id;
+                if (!r.get(id)) return false;
+                eventManager.deleteEvent(id);
+                return true;
+            }
+            case LogOp::BookEvent: {
+                int32_t eventId, fanId;
+                uint8_t type;
+                int64_t price;
+                // the seat and ticket id too, so the replay gives the fan the same seat and ticket id
+                Seat seat;
+                uint64_t ticketId;
+                if (!r.get(eventId) || !r.get(fanId) || !r.get(type) || !r.get(price) || !readSeat(r, seat) ||
+                    !r.get(ticketId))
+                    return false;
+                Event* e = eventManager.getEvent(eventId);
+                if (e == nullptr) return true;
+                Ticket t(eventId, fanId, TicketTypePrice{(TicketType)type, Money::fromPiastres(price)});
+                t.setTicketStatus(TicketStatus::Reserved);
+                t.setSeat(seat);
+                if ((int)(ticketId >> 32) == eventId) t.setId(ticketId);
+                Fan* fan = FanManager::getInstance().getFan(fanId);
+                if (e->rebook(t) && fan != nullptr) fan->buyTicket(t);
+                return true;
+            }
+            case LogOp::SetSeatMap: {
+                int32_t eventId;
+                uint8_t type;
+                SeatLayout layout;
+                if (!r.get(eventId) || !r.get(type) || !readLayout(r, layout)) return false;
+                Event* e = eventManager.getEvent(eventId);
+                if (e != nullptr) e->setSeatMap((TicketType)type, layout);
+                return true;
+            }
+            case LogOp::AddFan: {
+                Fan fan;
+                int32_t id;
+                if (!readUser(r, fan) || !r.get(id)) return false;
+                fan.setId(id);
+                FanManager::getInstance().addFan(fan);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Caller holds logMutex (or is the only thread), logFile is a new empty log
+    bool writeLogHeader() {
+        vector<char> header(LOG_MAGIC, LOG_MAGIC + sizeof(LOG_MAGIC));
+        BinaryWriter w(header);
+        w.put<uint32_t>(LOG_VERSION);
+        return fwrite(header.data(), 1, header.size(), logFile) == header.size() && syncFile(logFile);
+    }
+
+    // Replays the log, validSize = size of its valid prefix (0 when it has no complete header yet)
+    // false for a log of another format version, nothing is replayed from it
+    bool replayLog(size_t& validSize) {
+        validSize = 0;
+        vector<char> data;
+        if (!readFile(logPath, data)) return true;
+        // shorter than any record of a headerless log, a header torn by a crash in rotate()
+        if (data.size() < LOG_HEADER_SIZE) return true;
+        uint32_t version;
+        memcpy(&version, data.data() + sizeof(LOG_MAGIC), sizeof(version));
+        if (memcmp(data.data(), LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || version != LOG_VERSION) return false;
+
+        // Record: [uint32 payload size][uint8 op][payload][uint32 checksum of op + payload]
+        size_t offset = LOG_HEADER_SIZE;
+        while (data.size() - offset >= sizeof(uint32_t) + 1) {
+            uint32_t size;
+            memcpy(&size, data.data() + offset, sizeof(size));
+            size_t recordSize = sizeof(uint32_t) + 1 + size + sizeof(uint32_t);
+            if (data.size() - offset < recordSize) break;
+
+            const char* body = data.data() + offset + sizeof(uint32_t);
+            uint32_t storedSum;
+            memcpy(&storedSum, body + 1 + size, sizeof(storedSum));
+            if (storedSum != checksum(body, 1 + size)) break;
+
+            BinaryReader r(body + 1, size);
+            if (!replay((LogOp)body[0], r)) break;
+            offset += recordSize;
+        }
+        validSize = offset;
+        return true;
+    }
+
+    // Appends one record and returns once it is on disk. Concurrent callers share one fsync:
+    // the first thread in becomes the leader and syncs everything pending, the rest wait for it.
+    bool commit(LogOp op, const vector<char>& payload) {
+        unique_lock<mutex> lock(logMutex);
+        if (logFile == nullptr) return false;
+
+        BinaryWriter w(pending);
+        w.put<uint32_t>(payload.size());
+        size_t bodyStart = pending.size();
+        w.put<uint8_t>((uint8_t)op);
+        pending.insert(pending.end(), payload.begin(), payload.end());
+        w.put<uint32_t>(checksum(pending.data() + bodyStart, pending.size() - bodyStart));
+        uint64_t mySeq = ++appendedSeq;
+
+        while (durableSeq < mySeq) {
+            if (syncing) {
+                logSynced.wait(lock);
+                continue;
+            }
+            syncing = true;
+            vector<char> batch;
+            batch.swap(pending);
+            uint64_t batchEnd = appendedSeq;
+
+            lock.unlock();
+            bool ok = fwrite(batch.data(), 1, batch.size(), logFile) == batch.size() && syncFile(logFile);
+            lock.lock();
+
+            lastSyncOk = ok;
+            syncing = false;
+            durableSeq = batchEnd;
+            logSynced.notify_all();
+        }
+        return lastSyncOk;
+    }
+
+public:
+    static StorageManager& getInstance() {
+        static StorageManager instance; // Magic Static
+        return instance;
+    }
+
+    // Loads the snapshot, replays the log on top of it and opens the log for appending
+    // Returns false if the stored data is unreadable, the managers then keep what was loaded
+    // A log of another format version is left as it is and not opened, nothing is logged
+    bool open(const string& dataDir = "data") {
+        error_code ec;
+        filesystem::create_directories(dataDir, ec);
+        snapshotPath = dataDir + "/ticketak.snap";
+        logPath = dataDir + "/ticketak.wal";
+
+        bool ok = loadSnapshot();
+        size_t validLogSize;
+        if (!replayLog(validLogSize)) return false;
+
+        // Cut off a torn tail so new records are not appended after garbage
+        if (filesystem::exists(logPath, ec) && filesystem::file_size(logPath, ec) != validLogSize)
+            filesystem::resize_file(logPath, validLogSize, ec);
+
+        logFile = fopen(logPath.c_str(), "ab");
+        if (logFile != nullptr && validLogSize == 0 && !writeLogHeader()) ok = false;
+        return ok && logFile != nullptr;
+    }
+
+    // Held by a change to the managers from before it changes them until its log record is written
+    // (and anything else the snapshot reads is updated, e.g. the fan's tickets). checkpoint() waits
+    // for the running changes and holds new ones back, so each change is either in the snapshot
+    // with its record in the old log, or out of it with its record in the new log, never both.
+    // Note: not to be taken by a thread that calls checkpoint() while holding it
+    class ChangeGuard {
+    private:
+        StorageManager& storage;
+
+    public:
+        explicit ChangeGuard(StorageManager& storage) : storage(storage) {
+            unique_lock<mutex> lock(storage.cutMutex);
+            storage.cutChanged.wait(lock, [&storage] { return !storage.cutting; });
+            storage.changesRunning++;
+        }
+
+        ~ChangeGuard() {
+            lock_guard<mutex> lock(storage.cutMutex);
+            if (--storage.changesRunning == 0) storage.cutChanged.notify_all();
+        }
+
+        ChangeGuard(const ChangeGuard&) = delete;
+        ChangeGuard& operator=(const ChangeGuard&) = delete;
+    };
+
+    // Writes a fresh snapshot and empties the log, at a cut between changes (ChangeGuard)
+    // managersLock is the lock other threads read the managers under (TicketakService's), it is
+    // held while the snapshot walks them; none is needed while only one thread uses them
+    bool checkpoint(mutex* managersLock = nullptr) {
+        {
+            unique_lock<mutex> cut(cutMutex);
+            cutChanged.wait(cut, [this] { return !cutting; });
+            cutting = true;
+            cutChanged.wait(cut, [this] { return changesRunning == 0; });
+        }
+        bool ok;
+        {
+            unique_lock<mutex> managers;
+            if (managersLock != nullptr) managers = unique_lock<mutex>(*managersLock);
+            ok = rotate();
+        }
+        {
+            lock_guard<mutex> cut(cutMutex);
+            cutting = false;
+        }
+        cutChanged.notify_all();
+        return ok;
+    }
+
+    void close() {
+        unique_lock<mutex> lock(logMutex);
+        logSynced.wait(lock, [this] { return !syncing; });
+        if (logFile) fclose(logFile);
+        logFile = nullptr;
+    }
+
+    bool logAddEvent(const Event& e) {
+        vector<char> payload;
+        BinaryWriter w(payload);
+        writeEventCore(w, e);
+        return commit(LogOp::AddEvent, payload);
+    }
+
+    bool logEditEvent(const Event& e) {
+        vector<char> payload;
+        BinaryWriter w(payload);
+        writeEventCore(w, e);
+        return commit(LogOp::EditEvent, payload);
+    }
+
+    bool logDeleteEvent(int eventId) {
+        vector<char> payload;
+        BinaryWriter w(payload);
+        w.put<int32_t>(eventId);
+        return commit(LogOp::DeleteEvent, payload);
+    }
+
+    bool logBookEvent(const Ticket& t) {
+        vector<char> payload;
+        BinaryWriter w(payload);
+        w.put<int32_t>(t.getEventId());
+        w.put<int32_t>(t.getFanId());
+        w.put<uint8_t>((uint8_t)t.getTypePrice().type);
+        w.put<int64_t>(t.getPrice().piastres());
+        writeSeat(w, t.getSeat());
+        w.put<uint64_t>(t.getId());
+        return commit(LogOp::BookEvent, payload);
+    }
+
+    bool logSeatMap(int eventId, TicketType type, const SeatMap* seats) {
+        vector<char> payload;
+        BinaryWriter w(payload);
+        w.put<int32_t>(eventId);
+        w.put<uint8_t>((uint8_t)type);
+        writeLayout(w, seats);
+        return commit(LogOp::SetSeatMap, payload);
+    }
+
+    bool logAddFan(const Fan& fan) {
+        vector<char> payload;
+        BinaryWriter w(payload);
+        writeUser(w, fan);
+        w.put<int32_t>(fan.getId());
+        return commit(LogOp::AddFan, payload);
+    }
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <conio.h>
+#else
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Keys other than characters, returned by Terminal::readKey after the character range
+enum TerminalKey : int {
+    KeyUp = 0x100,
+    KeyDown,
+    KeyLeft,
+    KeyRight,
+    KeyHome,
+    KeyEnd,
+    KeyDelete,
+    KeyPageUp,
+    KeyPageDown
+};
+
+// Screen and keyboard of the console application. Output (cursor moves, colors, text, clears) is
+// ANSI escape sequences collected into one frame, written with a single call when the program
+// next waits for a key or calls flush(). Keys come back decoded: characters as themselves (Enter
+// as '\r', Backspace as 8, Esc as 27) and the rest as a TerminalKey.
+//
+// Subclasses only move bytes: PosixTerminal over termios, ConsoleTerminal over the Windows console.
+class Terminal {
+public:
+    // room for a full screen of form or menu, so drawing frames does not grow the buffer
+    Terminal() { frame.reserve(8192); }
+    virtual ~Terminal() = default;
+
+    static Terminal& getInstance();
+
+    void moveTo(int x, int y) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "\x1b[%d;%dH", y + 1, x + 1);
+        frame += buf;
+    }
+
+    // Console attribute as in SetConsoleTextAttribute: low nibble foreground, high nibble background
+    void setAttr(int attr) {
+        if ((attr & 0xFF) == 0x07) {
+            frame += "\x1b[0m";
+            return;
+        }
+        int fg = attr & 0xF, bg = (attr >> 4) & 0xF;
+        char buf[32];
+        snprintf(buf, sizeof(buf), "\x1b[0;%d;%dm", (fg & 8 ? 90 : 30) + ansiColor(fg), (bg & 8 ? 100 : 40) + ansiColor(bg));
+        frame += buf;
+    }
+
+    void clear() { frame += "\x1b[0m\x1b[H\x1b[2J"; }
+
+    void write(const string& text) { frame += text; }
+    void write(const char* text) { frame += text; }
+    void write(const char* text, size_t n) { frame.append(text, n); }
+
+    // Writes the frame so far, after anything still buffered in cout
+    void flush() {
+        cout.flush();
+        if (frame.empty()) return;
+        writeOut(frame.data(), frame.size());
+        frame.clear();
+    }
+
+    int readKey() {
+        flush();
+        return nextKey();
+    }
+
+protected:
+    virtual void writeOut(const char* data, size_t n) = 0;
+    virtual int nextKey() = 0;
+
+private:
+    string frame;
+
+    // Windows color bits are blue 1, green 2, red 4; ANSI numbers them red 1, green 2, blue 4
+    static int ansiColor(int windowsColor) {
+        return (windowsColor & 1 ? 4 : 0) | (windowsColor & 2) | (windowsColor & 4 ? 1 : 0);
+    }
+};
+
+#ifndef _WIN32
+
+// Terminal over file descriptors: raw-ish mode (no line buffering or echo, Enter as '\r', Ctrl-C
+// still works) while it lives, and one write() per frame. Reads end with Esc when input ends.
+class PosixTerminal : public Terminal {
+public:
+    explicit PosixTerminal(int inFd = STDIN_FILENO, int outFd = STDOUT_FILENO) : inFd(inFd), outFd(outFd) {
+        if (isatty(inFd) && tcgetattr(inFd, &saved) == 0) {
+            termios raw = saved;
+            raw.c_lflag &= ~(ICANON | ECHO);
+            raw.c_iflag &= ~(IXON | ICRNL);
+            raw.c_cc[VMIN] = 1;
+            raw.c_cc[VTIME] = 0;
+            rawMode = tcsetattr(inFd, TCSAFLUSH, &raw) == 0;
+        }
+    }
+
+    ~PosixTerminal() override {
+        flush();
+        if (rawMode) tcsetattr(inFd, TCSAFLUSH, &saved);
+    }
+
+protected:
+    void writeOut(const char* data, size_t n) override {
+        while (n > 0) {
+            ssize_t written = ::write(outFd, data, n);
+            if (written <= 0) return;
+            data += written;
+            n -= (size_t)written;
+        }
+    }
+
+    int nextKey() override {
+        while (true) {
+            int ch = readByte(-1);
+            if (ch < 0) return 27;
+            if (ch == 127) return 8;
+            if (ch == '\n') return '\r';
+            if (ch != 27) return ch;
+            // a lone Esc, or the start of an escape sequence arriving right behind it
+            int key = readEscape();
+            if (key != 0) return key;
+        }
+    }
+
+private:
+    int inFd;
+    int outFd;
+    termios saved{};
+    bool rawMode = false;
+
+    // next byte, -1 at the end of input or when nothing came within timeoutMs (-1 waits)
+    int readByte(int timeoutMs) {
+        if (timeoutMs >= 0) {
+            pollfd p{inFd, POLLIN, 0};
+            if (poll(&p, 1, timeoutMs) <= 0) return -1;
+        }
+        unsigned char c;
+        return ::read(inFd, &c, 1) == 1 ? c : -1;
+    }
+
+    // After an Esc: the key of an "ESC [ ..." or "ESC O ..." sequence, 27 for Esc alone, 0 if unknown
+    int readEscape() {
+        int intro = readByte(30);
+        if (intro != '[' && intro != 'O') return 27;
+        int ch = readByte(30);
+        int number = 0;
+        while (ch >= '0' && ch <= '9') {
+            number = number * 10 + (ch - '0');
+            ch = readByte(30);
+        }
+        switch (ch) {
+            case 'A': return KeyUp;
+            case 'B': return KeyDown;
+            case 'C': return KeyRight;
+            case 'D': return KeyLeft;
+            case 'H': return KeyHome;
+            case 'F': return KeyEnd;
+            case '~':
+                switch (number) {
+                    case 1: case 7: return KeyHome;
+                    case 4: case 8: return KeyEnd;
+                    case 3: return KeyDelete;
+                    case 5: return KeyPageUp;
+                    case 6: return KeyPageDown;
+                }
+        }
+        return 0;
+    }
+};
+
+inline Terminal& Terminal::getInstance() {
+    static PosixTerminal instance; // Magic Static
+    return instance;
+}
+
+#else
+
+// Terminal over the Windows console, with virtual terminal processing on for the ANSI sequences
+class ConsoleTerminal : public Terminal {
+public:
+    ConsoleTerminal() {
+        out = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        if (GetConsoleMode(out, &mode)) SetConsoleMode(out, mode | 0x0004); // ENABLE_VIRTUAL_TERMINAL_PROCESSING
+    }
+
+    ~ConsoleTerminal() override { flush(); }
+
+protected:
+    void writeOut(const char* data, size_t n) override {
+        DWORD written = 0;
+        WriteFile(out, data, (DWORD)n, &written, nullptr);
+    }
+
+    int nextKey() override {
+        int ch = _getch();
+        // arrows and the editing keys come as a 0 or 224 prefix and a scan code
+        if (ch == 0 || ch == 224) {
+            switch (_getch()) {
+                case 72: return KeyUp;
+                case 80: return KeyDown;
+                case 75: return KeyLeft;
+                case 77: return KeyRight;
+                case 71: return KeyHome;
+                case 79: return KeyEnd;
+                case 83: return KeyDelete;
+                case 73: return KeyPageUp;
+                case 81: return KeyPageDown;
+                default: return nextKey();
+            }
+        }
+        return ch;
+    }
+
+private:
+    HANDLE out;
+};
+
+inline Terminal& Terminal::getInstance() {
+    static ConsoleTerminal instance; // Magic Static
+    return instance;
+}
+
+#endif
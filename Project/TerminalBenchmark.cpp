@@ -0,0 +1,163 @@
+// Frame time of the console on a POSIX terminal, fork-per-clear against PosixTerminal
+// Draws --frames frames of an 11 field form (the add event form) both ways into /dev/null: the old
+// way clears with system("clear") (system("cls") on Windows, a shell per clear) and makes one write
+// per cursor move, color change and text, like the console API calls it replaces; PosixTerminal
+// buffers the frame and writes it once. Then feeds key sequences through a pipe and exits non-zero
+// if PosixTerminal decodes any of them wrong.
+//
+//   ticketak-terminal-bench [--frames 200]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Terminal.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+static const vector<string> labels = {"Event Name:", "Category:", "Day:", "Month:", "Year:", "VIP Price:",
+                                      "VIP Quantity:", "Regular Price:", "Regular Quantity:", "Economic Price:",
+                                      "Economic Quantity:"};
+
+// One showForm frame through t: labels, the fields' values highlighted, the ESC hint
+static void drawForm(Terminal& t) {
+    for (size_t i = 0; i < labels.size(); ++i) {
+        t.moveTo(2, 1 + (int)i * 2);
+        t.write(labels[i]);
+        t.moveTo(18, 1 + (int)i * 2);
+        t.setAttr(0x071);
+        t.write("value " + to_string(i) + string(14, ' '));
+        t.setAttr(0x007);
+    }
+    t.moveTo(0, (int)labels.size() * 2 + 3);
+    t.write("Press ESC to back.");
+}
+
+// Terminal that writes every call through at once, the way each console API call was its own call
+class WriteThroughTerminal : public Terminal {
+public:
+    explicit WriteThroughTerminal(int fd) : fd(fd) {}
+    size_t writes = 0;
+
+protected:
+    void writeOut(const char* data, size_t n) override {
+        writes++;
+        if (::write(fd, data, n) < 0) return;
+    }
+    int nextKey() override { return 27; }
+
+private:
+    int fd;
+};
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const int nFrames = stoi(argValue(argc, argv, "--frames", "200"));
+    int devNull = open("/dev/null", O_WRONLY);
+    if (devNull < 0) return 1;
+    setenv("TERM", "xterm", 0);
+
+    // old: the shell's clear goes to /dev/null too, stdout is pointed there while it runs
+    WriteThroughTerminal old(devNull);
+    int savedOut = dup(STDOUT_FILENO);
+    dup2(devNull, STDOUT_FILENO);
+    auto start = chrono::steady_clock::now();
+    for (int f = 0; f < nFrames; ++f) {
+        if (system("clear") != 0) break;
+        // flush after every call
+        for (size_t i = 0; i < labels.size(); ++i) {
+            old.moveTo(2, 1 + (int)i * 2);
+            old.flush();
+            old.write(labels[i]);
+            old.flush();
+            old.moveTo(18, 1 + (int)i * 2);
+            old.flush();
+            old.setAttr(0x071);
+            old.flush();
+            old.write("value " + to_string(i) + string(14, ' '));
+            old.flush();
+            old.setAttr(0x007);
+            old.flush();
+        }
+        old.moveTo(0, (int)labels.size() * 2 + 3);
+        old.flush();
+        old.write("Press ESC to back.");
+        old.flush();
+    }
+    double oldMicros = seconds(start) * 1e6 / nFrames;
+    fflush(stdout);
+    dup2(savedOut, STDOUT_FILENO);
+
+    const int newFrames = nFrames * 500;
+    size_t bytes = 0;
+    {
+        PosixTerminal term(STDIN_FILENO, devNull);
+        start = chrono::steady_clock::now();
+        for (int f = 0; f < newFrames; ++f) {
+            term.clear();
+            drawForm(term);
+            term.flush();
+        }
+    }
+    double newMicros = seconds(start) * 1e6 / newFrames;
+    {
+        // size of one frame
+        int pipeFds[2];
+        if (pipe(pipeFds) != 0) return 1;
+        PosixTerminal term(STDIN_FILENO, pipeFds[1]);
+        term.clear();
+        drawForm(term);
+        term.flush();
+        char buf[4096];
+        ssize_t n = read(pipeFds[0], buf, sizeof(buf));
+        bytes = n > 0 ? (size_t)n : 0;
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+    }
+
+    char line[200];
+    snprintf(line, sizeof(line), "system(\"clear\") + a write per call: %9.1f us/frame, %zu writes/frame", oldMicros,
+             old.writes / (size_t)nFrames);
+    cout << line << endl;
+    snprintf(line, sizeof(line), "PosixTerminal, one buffered write:  %9.2f us/frame, 1 write/frame (%zu bytes), %.0fx faster",
+             newMicros, bytes, oldMicros / newMicros);
+    cout << line << endl;
+
+    // key decoding: arrows, editing keys in both encodings, Enter, Backspace, a lone Esc, end of input
+    int keysFds[2];
+    if (pipe(keysFds) != 0) return 1;
+    const string input = "a\x1b[A\x1b[B\x1b[C\x1b[D\x1b[H\x1b[F\x1bOH\x1b[1~\x1b[4~\x1b[3~\x1b[5~\x1b[6~\r\n\x7f\x1b";
+    if (write(keysFds[1], input.data(), input.size()) != (ssize_t)input.size()) return 1;
+    close(keysFds[1]);
+    const vector<int> expected = {'a', KeyUp, KeyDown, KeyRight, KeyLeft, KeyHome, KeyEnd, KeyHome, KeyHome, KeyEnd,
+                                  KeyDelete, KeyPageUp, KeyPageDown, '\r', '\r', 8, 27, 27};
+    bool ok = true;
+    {
+        PosixTerminal keys(keysFds[0], devNull);
+        for (size_t i = 0; i < expected.size() && ok; ++i) {
+            int key = keys.readKey();
+            if (key != expected[i]) {
+                cout << "key " << i << ": got " << key << ", expected " << expected[i] << endl;
+                ok = false;
+            }
+        }
+    }
+    close(keysFds[0]);
+    close(devNull);
+    cout << (ok ? "key decoding checks passed" : "key decoding checks FAILED") << endl;
+    return ok ? 0 : 1;
+}
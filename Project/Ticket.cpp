@@ -1,16 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
+#include "Money.cpp"
+
 using namespace std;
 
-enum class TicketType {
+enum class TicketType : uint8_t {
     VIP,
     Economic,
     Regular
 };
 
-enum class TicketStatus {
+enum class TicketStatus : uint8_t {
     Available,
     Reserved,
     Expired
@@ -18,32 +21,55 @@ enum class TicketStatus {
 
 struct TicketTypePrice {
     TicketType type;
-    double price;
+    Money price;
+};
+
+// Numbered seat of a ticket, 0-based; section -1 = general admission (no seat)
+struct Seat {
+    int section = -1;
+    int row = -1;
+    int number = -1;
+
+    bool isAssigned() const { return section >= 0; }
 };
 
+// Packed ticket record (32 bytes). The id is [event id : 32][TicketStore row : 32] so it says which
+// event the ticket is for and where it is stored; row 0 is never used, a ticket whose row is 0 is not
+// stored yet and id 0 means no ticket at all. Seats are 16-bit.
 class Ticket {
 private:
-    string id;
-    int eventId;
-    int fanId;
-    TicketTypePrice typePrice;
-    TicketStatus status;
+    uint64_t id = 0;
+    int32_t fanId = 0;
+    TicketType type = TicketType::Economic;
+    TicketStatus status = TicketStatus::Available;
+    int16_t section = -1;
+    int16_t row = -1;
+    int16_t number = -1;
+    Money price;
 
 public:
-    Ticket() : Ticket("0", 0, 0, TicketTypePrice{TicketType::Economic, 0}) {}
+    Ticket() = default;
 
-    Ticket(string id, int eventId, int fanId,TicketTypePrice typePrice){
-        this->id = id;
-        this-> eventId = eventId;
+    // Not stored yet, TicketStore::append gives it its id
+    Ticket(int eventId, int fanId, TicketTypePrice typePrice) {
+        this->id = (uint64_t)(uint32_t)eventId << 32;
         this->fanId = fanId;
-        this->typePrice = typePrice;
-        status = TicketStatus::Available;
+        this->type = typePrice.type;
+        this->price = typePrice.price;
     }
 
-    string getId() {return id; }
-    int getEventId() {return eventId; }
-    int getFanId() {return fanId; }
-    double getPrice() { return typePrice.price; }
+    static uint64_t makeId(int eventId, uint32_t row) { return ((uint64_t)(uint32_t)eventId << 32) | row; }
+
+    // false for the empty ticket a failed booking returns
+    bool isValid() const { return (uint32_t)id != 0; }
+
+    uint64_t getId() const { return id; }
+    // Printable id, "<event>-<number>"
+    string getIdStr() const { return to_string(getEventId()) + "-" + to_string(getRow()); }
+    uint32_t getRow() const { return (uint32_t)id; }
+    int getEventId() const { return (int)(uint32_t)(id >> 32); }
+    int getFanId() const { return fanId; }
+    Money getPrice() const { return price; }
     TicketStatus getTicketStatus() const { return status; }
     
     string getTicketStatusStr() const { 
@@ -59,10 +85,18 @@ public:
         }
     }
 
-    TicketTypePrice getTypePrice() { return typePrice;}
+    TicketTypePrice getTypePrice() const { return TicketTypePrice{type, price}; }
 
-    string getType(){
-        switch (typePrice.type) {
+    Seat getSeat() const { return Seat{section, row, number}; }
+
+    string getSeatStr() const {
+        if (section < 0) return "General admission";
+        return "Section " + to_string(section + 1) + ", Row " + to_string(row + 1) +
+            ", Seat " + to_string(number + 1);
+    }
+
+    string getType() const {
+        switch (type) {
             case TicketType::VIP:      return "VIP";
             case TicketType::Economic: return "Economic";
             case TicketType::Regular:  return "Regular";
@@ -71,9 +105,17 @@ public:
     }
 
     // Getters and Setters
-    void setId(string id) { this->id = id; }
-    void setEventId(int eventId) { this->eventId = eventId; }
+    void setId(uint64_t id) { this->id = id; }
     void setFanId(int id) { fanId = id; }
-    void setTicketTypePrice(TicketTypePrice typePrice) { this->typePrice = typePrice; }
+    void setTicketTypePrice(TicketTypePrice typePrice) {
+        type = typePrice.type;
+        price = typePrice.price;
+    }
+    void setPrice(Money price) { this->price = price; }
     void setTicketStatus(TicketStatus status) { this->status = status; }
+    void setSeat(Seat seat) {
+        section = (int16_t)seat.section;
+        row = (int16_t)seat.row;
+        number = (int16_t)seat.number;
+    }
 };
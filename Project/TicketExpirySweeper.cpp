@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TicketStore.cpp"
+
+using namespace std;
+
+// Progress of the sweeper, a snapshot of its counters
+struct ExpiryProgress {
+    size_t eventsQueued = 0;   // finished events handed to enqueue()
+    size_t eventsSwept = 0;    // of those, every ticket expired
+    size_t ticketsExpired = 0;
+    size_t batches = 0;
+    size_t pending = 0;        // events waiting in the queue
+};
+
+// Expires the tickets of finished events off the request path. The status clock enqueues the
+// events it finishes, a background thread takes everything queued (usually one tick's events),
+// resolves each event to its ticket ids and marks them Expired in the TicketStore batchSize at a
+// time, so no fan request or page render does it. Events with few tickets share a batch.
+// Without start(), sweep() does the same work on the calling thread.
+//
+// An event finished but not swept yet reads as Finished, its tickets are shown as expired. A
+// sweep still queued at shutdown is lost, the first status tick after restart finishes it again.
+class TicketExpirySweeper {
+public:
+    // Ticket ids of a finished event, empty if it is gone or not finished
+    using Resolver = function<vector<uint64_t>(int eventId)>;
+
+    explicit TicketExpirySweeper(Resolver resolver, size_t batchSize = 4096)
+        : resolver(move(resolver)), batchSize(max<size_t>(batchSize, 1)) {}
+
+    ~TicketExpirySweeper() { stop(); }
+
+    TicketExpirySweeper(const TicketExpirySweeper&) = delete;
+    TicketExpirySweeper& operator=(const TicketExpirySweeper&) = delete;
+
+    void start() {
+        lock_guard<mutex> lock(queueMutex);
+        if (sweeper.joinable()) return;
+        stopping = false;
+        sweeper = thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (sweeper.joinable()) sweeper.join();
+    }
+
+    void enqueue(const vector<int>& eventIds) {
+        if (eventIds.empty()) return;
+        {
+            lock_guard<mutex> lock(queueMutex);
+            queue.insert(queue.end(), eventIds.begin(), eventIds.end());
+            eventsQueued += eventIds.size();
+        }
+        wake.notify_all();
+    }
+
+    // Sweeps the queued events on the calling thread, returns how many tickets it expired
+    size_t sweep() {
+        size_t expired = 0;
+        vector<int> events;
+        vector<uint64_t> collected;
+        while (take(events)) {
+            // an event is counted as swept once the batch holding its last ticket is written
+            size_t collectedEvents = 0;
+            for (int eventId : events) {
+                vector<uint64_t> ids = resolver(eventId);
+                collected.insert(collected.end(), ids.begin(), ids.end());
+                collectedEvents++;
+                if (collected.size() >= batchSize) expired += expire(collected, collectedEvents);
+            }
+            expired += expire(collected, collectedEvents);
+        }
+        return expired;
+    }
+
+    // Blocks until the queue is empty and no event is being swept
+    void waitIdle() {
+        unique_lock<mutex> lock(queueMutex);
+        idle.wait(lock, [this] { return queue.empty() && sweeping == 0; });
+    }
+
+    ExpiryProgress progress() {
+        lock_guard<mutex> lock(queueMutex);
+        ExpiryProgress p;
+        p.eventsQueued = eventsQueued;
+        p.eventsSwept = eventsSwept;
+        p.ticketsExpired = ticketsExpired.load();
+        p.batches = batches.load();
+        p.pending = queue.size();
+        return p;
+    }
+
+private:
+    Resolver resolver;
+    size_t batchSize;
+
+    mutex queueMutex;
+    condition_variable wake;
+    condition_variable idle;
+    deque<int> queue;
+    int sweeping = 0;
+    bool stopping = false;
+    thread sweeper;
+
+    size_t eventsQueued = 0;
+    size_t eventsSwept = 0;
+    atomic<size_t> ticketsExpired{0};
+    atomic<size_t> batches{0};
+
+    // Moves every queued event to events
+    bool take(vector<int>& events) {
+        lock_guard<mutex> lock(queueMutex);
+        if (queue.empty() || stopping) return false;
+        events.assign(queue.begin(), queue.end());
+        queue.clear();
+        sweeping += (int)events.size();
+        return true;
+    }
+
+    // Expires the collected ids batchSize at a time, then counts their events as swept
+    size_t expire(vector<uint64_t>& ids, size_t& events) {
+        TicketStore& store = TicketStore::getInstance();
+        size_t expired = 0;
+        for (size_t from = 0; from < ids.size(); from += batchSize) {
+            size_t end = min(ids.size(), from + batchSize);
+            size_t batchExpired = 0;
+            for (size_t i = from; i < end; ++i) {
+                if (store.setStatus(ids[i], TicketStatus::Expired)) batchExpired++;
+            }
+            batches++;
+            ticketsExpired += batchExpired;
+            expired += batchExpired;
+        }
+        ids.clear();
+        if (events == 0) return expired;
+
+        lock_guard<mutex> lock(queueMutex);
+        eventsSwept += events;
+        sweeping -= (int)events;
+        events = 0;
+        if (sweeping == 0 && queue.empty()) idle.notify_all();
+        return expired;
+    }
+
+    void run() {
+        unique_lock<mutex> lock(queueMutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) break;
+            lock.unlock();
+            sweep();
+            lock.lock();
+        }
+    }
+};
@@ -0,0 +1,143 @@
+// Memory taken by booked tickets, old representation vs the TicketStore
+// Books --tickets tickets spread over --events events and --fans fans twice: as the old full Ticket
+// copies (string id, double price, one copy in the event and one in the fan), then through
+// Event::bookEvent into the TicketStore with ids in the Event and the Fan. Reports the bytes the
+// containers hold and, on Linux, the growth of the resident set, then times reading one fan with
+// --season tickets in full against reading one page of 50.
+//
+//   ticketak-ticket-memory [--tickets 10000000] [--events 1000] [--fans 100000] [--season 20000]
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "EventManager.cpp"
+#include "Fan.cpp"
+
+using namespace std;
+
+// Ticket as it was stored before the TicketStore
+struct OldTicket {
+    string id;
+    int eventId;
+    int fanId;
+    struct {
+        int type;
+        double price;
+    } typePrice;
+    int status;
+    Seat seat;
+};
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// Resident set in bytes, 0 where /proc is not available
+static size_t residentBytes() {
+    size_t pages = 0, resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (f == nullptr) return 0;
+    if (fscanf(f, "%zu %zu", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return resident * 4096;
+}
+
+template <typename T>
+static size_t heldBytes(const vector<vector<T>>& lists) {
+    size_t total = 0;
+    for (const vector<T>& list : lists) total += list.capacity() * sizeof(T);
+    return total;
+}
+
+static void report(const char* name, long long tickets, size_t bytes, size_t rss, double seconds) {
+    char line[200];
+    snprintf(line, sizeof(line), "%-7s %10.1f MB held (%5.1f B/ticket)  RSS +%8.1f MB  %.2f s",
+             name, bytes / 1e6, (double)bytes / tickets, rss / 1e6, seconds);
+    cout << line << endl;
+}
+
+int main(int argc, char* argv[]) {
+    const long long nTickets = stoll(argValue(argc, argv, "--tickets", "10000000"));
+    const int nEvents = stoi(argValue(argc, argv, "--events", "1000"));
+    const int nFans = stoi(argValue(argc, argv, "--fans", "100000"));
+    const int nSeason = stoi(argValue(argc, argv, "--season", "20000"));
+    const int perEvent = (int)((nTickets + nEvents - 1) / nEvents);
+    const TicketTypePrice regular{TicketType::Regular, Money::pounds(250)};
+
+    cout << nTickets << " tickets, " << nEvents << " events, " << nFans << " fans" << endl;
+    cout << "sizeof: old Ticket " << sizeof(OldTicket) << " B, packed Ticket " << sizeof(Ticket) << " B" << endl;
+
+    // the packed store first, its chunks are never freed so the old layout cannot reuse them
+    vector<Event> events;
+    events.reserve(nEvents);
+    for (int e = 0; e < nEvents; ++e) {
+        events.emplace_back(e + 1, "Event " + to_string(e + 1), Category::Sports, Date{1, 1, 2099},
+                            TicketTypePriceQuantity{TicketType::VIP, Money(), 0},
+                            TicketTypePriceQuantity{TicketType::Economic, Money(), 0},
+                            TicketTypePriceQuantity{TicketType::Regular, regular.price, perEvent});
+    }
+    vector<Fan> fans(nFans);
+    size_t rssBefore = residentBytes();
+    auto start = chrono::steady_clock::now();
+    for (long long i = 0; i < nTickets; ++i) {
+        int fanId = (int)(i % nFans);
+        Ticket t = events[i % nEvents].bookEvent(fanId + 1, regular);
+        fans[fanId].buyTicket(t);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t rssPacked = residentBytes() - rssBefore;
+    size_t packedBytes = TicketStore::getInstance().memoryUsage();
+    for (const Fan& fan : fans) packedBytes += fan.getMyTicketIds().capacity() * sizeof(uint64_t);
+    // an event keeps one 32-bit row per ticket
+    packedBytes += nTickets * sizeof(uint32_t);
+
+    rssBefore = residentBytes();
+    start = chrono::steady_clock::now();
+    vector<vector<OldTicket>> eventTickets(nEvents), fanTickets(nFans);
+    for (long long i = 0; i < nTickets; ++i) {
+        vector<OldTicket>& log = eventTickets[i % nEvents];
+        OldTicket t{to_string(log.size() + 1), (int)(i % nEvents) + 1, (int)(i % nFans) + 1,
+                    {(int)regular.type, regular.price.toDouble()}, (int)TicketStatus::Reserved, Seat()};
+        log.push_back(t);
+        fanTickets[i % nFans].push_back(t);
+    }
+    double oldSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t rssOld = residentBytes() - rssBefore;
+    size_t oldBytes = heldBytes(eventTickets) + heldBytes(fanTickets);
+
+    report("old", nTickets, oldBytes, rssOld, oldSeconds);
+    report("packed", nTickets, packedBytes, rssPacked, seconds);
+    char line[80];
+    snprintf(line, sizeof(line), "%.1fx smaller", (double)oldBytes / packedBytes);
+    cout << line << endl;
+
+    // a season ticket holder, the whole list against one page from the middle of it
+    Event seasonEvent(nEvents + 1, "Season", Category::Sports, Date{1, 1, 2099},
+                      TicketTypePriceQuantity{TicketType::VIP, Money(), 0},
+                      TicketTypePriceQuantity{TicketType::Economic, Money(), 0},
+                      TicketTypePriceQuantity{TicketType::Regular, regular.price, nSeason});
+    Fan season;
+    for (int i = 0; i < nSeason; ++i) season.buyTicket(seasonEvent.bookEvent(1, regular));
+    const int reads = 200;
+    size_t sink = 0;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < reads; ++r) sink += season.getMyTickets().size();
+    double fullMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / reads;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < reads; ++r) sink += season.getMyTickets(nSeason / 2, 50).size();
+    double pageMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / reads;
+    snprintf(line, sizeof(line), "fan with %d tickets: all %.1f us, page of 50 %.2f us", nSeason, fullMicros, pageMicros);
+    cout << line << endl;
+
+    long long stored = 0;
+    for (const Event& e : events) stored += e.getTicketCount();
+    bool pageOk = season.getMyTickets(nSeason / 2, 50).size() == (size_t)min(50, nSeason - nSeason / 2) &&
+        season.getMyTicketIds(nSeason, 50).empty() && sink > 0;
+    return stored == nTickets && seasonEvent.getTicketCount() == (size_t)nSeason && pageOk ? 0 : 1;
+}
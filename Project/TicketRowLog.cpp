@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+// TicketStore rows of one event's booked tickets, appended by concurrent buyers without a lock.
+// claim() reserves slots with a CAS on the claimed count (it never runs past CAPACITY, so a full
+// log refuses without using anything up) and set() stores a row into one. Slots live in segments of
+// doubling size (64, 128, 256, ...) that never move, so readers walk them while rows are appended;
+// a segment is created by the first push that reaches it, a losing racer frees its copy.
+// A claimed slot reads 0 until its row is stored (row 0 is never a ticket) and readers skip it.
+class TicketRowLog {
+private:
+    static constexpr uint32_t BASE = 64;
+    static constexpr int SEGMENTS = 26;
+
+public:
+    // BASE * (2^26 - 1) slots, just under 2^32
+    static constexpr uint32_t CAPACITY = BASE * ((1u << SEGMENTS) - 1);
+
+private:
+
+    atomic<uint32_t> claimed{0};
+    atomic<uint32_t> stored{0};
+    atomic<atomic<uint32_t>*> segments[SEGMENTS] = {};
+
+    // segment k holds slots [BASE * (2^k - 1), BASE * (2^(k+1) - 1))
+    static int segmentOf(uint32_t slot) {
+        uint32_t q = slot / BASE + 1;
+        int k = 0;
+        while (q >>= 1) ++k;
+        return k;
+    }
+
+    static uint32_t segmentStart(int k) { return BASE * ((1u << k) - 1); }
+
+    atomic<uint32_t>* segment(int k) {
+        atomic<uint32_t>* seg = segments[k].load(memory_order_acquire);
+        if (seg != nullptr) return seg;
+        atomic<uint32_t>* fresh = new atomic<uint32_t>[(size_t)BASE << k]();
+        if (segments[k].compare_exchange_strong(seg, fresh, memory_order_acq_rel)) return fresh;
+        delete[] fresh;
+        return seg;
+    }
+
+    void clear() {
+        for (auto& seg : segments) delete[] seg.exchange(nullptr);
+        claimed = 0;
+        stored = 0;
+    }
+
+public:
+    TicketRowLog() = default;
+    TicketRowLog(const TicketRowLog&) = delete;
+    ~TicketRowLog() { clear(); }
+
+    // Not concurrent with pushes to either log (copying an Event)
+    TicketRowLog& operator=(const TicketRowLog& other) {
+        if (this == &other) return *this;
+        clear();
+        other.forEach([this](uint32_t row) { push(row); });
+        return *this;
+    }
+
+    // Claims slots [first, first + n), false without claiming anything when fewer than n are left
+    // A claimed slot that is never set stays empty and is skipped by readers
+    bool claim(uint32_t n, uint32_t& first) {
+        uint32_t current = claimed.load(memory_order_relaxed);
+        do {
+            if (n > CAPACITY - current) return false;
+        } while (!claimed.compare_exchange_weak(current, current + n, memory_order_relaxed));
+        first = current;
+        return true;
+    }
+
+    // Stores a row into a slot taken by claim()
+    void set(uint32_t slot, uint32_t row) {
+        int k = segmentOf(slot);
+        segment(k)[slot - segmentStart(k)].store(row, memory_order_release);
+        stored.fetch_add(1, memory_order_release);
+    }
+
+    // false only when every slot is taken
+    bool push(uint32_t row) {
+        uint32_t slot;
+        if (!claim(1, slot)) return false;
+        set(slot, row);
+        return true;
+    }
+
+    // Rows stored so far
+    size_t size() const { return stored.load(memory_order_acquire); }
+
+    // Calls f(row) for every stored row in slot order
+    template <typename F>
+    void forEach(F f) const {
+        uint32_t end = claimed.load(memory_order_acquire);
+        for (int k = 0; k < SEGMENTS && segmentStart(k) < end; ++k) {
+            const atomic<uint32_t>* seg = segments[k].load(memory_order_acquire);
+            if (seg == nullptr) continue; // its first push is still creating it
+            uint32_t n = min(end - segmentStart(k), BASE << k);
+            for (uint32_t i = 0; i < n; ++i) {
+                uint32_t row = seg[i].load(memory_order_acquire);
+                if (row != 0) f(row);
+            }
+        }
+    }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Ticket.cpp"
+
+using namespace std;
+
+// Singleton Class holding every booked ticket once, Events and Fans only keep ticket ids.
+//
+// Columnar: each field lives in its own array, so expiring an event's tickets touches only the
+// status column and a row costs 24 bytes. Rows are allocated in chunks of 64k that never move, a
+// ticket's row is the low half of its id so a lookup is two array reads and no lock. append()
+// reserves rows with one fetch_add, only a thread that opens a new chunk takes chunkMutex.
+//
+// Fields other than the status are written once, before the ticket's id is handed out. Rows are
+// never freed (a deleted event's tickets stay with the fans who bought them).
+class TicketStore {
+private:
+    static constexpr uint32_t CHUNK_BITS = 16;
+    static constexpr uint32_t CHUNK_ROWS = 1u << CHUNK_BITS;
+    static constexpr uint32_t MAX_CHUNKS = 1u << (32 - CHUNK_BITS);
+    // status column: set once the row is written, so a reserved row is not read half written
+    static constexpr uint8_t STORED = 0x80;
+
+    struct Chunk {
+        int32_t eventId[CHUNK_ROWS];
+        int32_t fanId[CHUNK_ROWS];
+        Money price[CHUNK_ROWS];
+        int16_t section[CHUNK_ROWS];
+        int16_t row[CHUNK_ROWS];
+        int16_t number[CHUNK_ROWS];
+        TicketType type[CHUNK_ROWS];
+        atomic<uint8_t> status[CHUNK_ROWS];
+    };
+
+    unique_ptr<atomic<Chunk*>[]> chunks;
+    mutex chunkMutex;
+    atomic<size_t> nChunks{0};
+    // next free row, row 0 is never used so a ticket id is never 0
+    atomic<uint32_t> nextRow{1};
+
+    TicketStore() : chunks(new atomic<Chunk*>[MAX_CHUNKS]) {
+        for (uint32_t i = 0; i < MAX_CHUNKS; ++i) chunks[i] = nullptr;
+    }
+
+    ~TicketStore() {
+        for (uint32_t i = 0; i < MAX_CHUNKS; ++i) delete chunks[i].load();
+    }
+
+    TicketStore(const TicketStore&) = delete;
+    TicketStore& operator=(const TicketStore&) = delete;
+
+    Chunk* chunkOf(uint32_t row) {
+        atomic<Chunk*>& slot = chunks[row >> CHUNK_BITS];
+        Chunk* chunk = slot.load(memory_order_acquire);
+        if (chunk != nullptr) return chunk;
+        lock_guard<mutex> lock(chunkMutex);
+        chunk = slot.load(memory_order_relaxed);
+        if (chunk == nullptr) {
+            chunk = new Chunk();
+            nChunks++;
+            slot.store(chunk, memory_order_release);
+        }
+        return chunk;
+    }
+
+    // nullptr if the row was never written
+    const Chunk* storedChunk(uint32_t row) const {
+        if (row == 0 || row >= nextRow.load()) return nullptr;
+        const Chunk* chunk = chunks[row >> CHUNK_BITS].load(memory_order_acquire);
+        if (chunk == nullptr || !(chunk->status[row & (CHUNK_ROWS - 1)].load(memory_order_acquire) & STORED))
+            return nullptr;
+        return chunk;
+    }
+
+    void write(uint32_t row, const Ticket& t) {
+        Chunk* chunk = chunkOf(row);
+        uint32_t i = row & (CHUNK_ROWS - 1);
+        Seat seat = t.getSeat();
+        chunk->eventId[i] = t.getEventId();
+        chunk->fanId[i] = t.getFanId();
+        chunk->price[i] = t.getPrice();
+        chunk->section[i] = (int16_t)seat.section;
+        chunk->row[i] = (int16_t)seat.row;
+        chunk->number[i] = (int16_t)seat.number;
+        chunk->type[i] = t.getTypePrice().type;
+        chunk->status[i].store((uint8_t)t.getTicketStatus() | STORED, memory_order_release);
+    }
+
+public:
+    static TicketStore& getInstance() {
+        static TicketStore instance; // Magic Static
+        return instance;
+    }
+
+    // Stores n new tickets in consecutive rows and gives each its id
+    // false (nothing stored) once all 2^32 - 1 rows are used
+    bool append(Ticket* tickets, size_t n) {
+        if (n == 0) return true;
+        uint32_t first = nextRow.fetch_add((uint32_t)n);
+        if (first == 0 || (uint64_t)first + n > UINT32_MAX) return false;
+        for (size_t k = 0; k < n; ++k) {
+            uint32_t row = first + (uint32_t)k;
+            tickets[k].setId(Ticket::makeId(tickets[k].getEventId(), row));
+            write(row, tickets[k]);
+        }
+        return true;
+    }
+
+    // Puts a ticket loaded from storage back at the row of its id, single threaded restore only
+    bool restore(const Ticket& t) {
+        uint32_t row = t.getRow();
+        if (row == 0 || row == UINT32_MAX) return false;
+        write(row, t);
+        if (nextRow.load() <= row) nextRow = row + 1;
+        return true;
+    }
+
+    // false if there is no ticket with this id
+    bool get(uint64_t id, Ticket& t) const {
+        uint32_t row = (uint32_t)id;
+        const Chunk* chunk = storedChunk(row);
+        if (chunk == nullptr) return false;
+        uint32_t i = row & (CHUNK_ROWS - 1);
+        if (chunk->eventId[i] != (int32_t)(id >> 32)) return false;
+        t = Ticket(chunk->eventId[i], chunk->fanId[i], TicketTypePrice{chunk->type[i], chunk->price[i]});
+        t.setId(id);
+        t.setSeat(Seat{chunk->section[i], chunk->row[i], chunk->number[i]});
+        t.setTicketStatus((TicketStatus)(chunk->status[i].load(memory_order_acquire) & ~STORED));
+        return true;
+    }
+
+    bool setStatus(uint64_t id, TicketStatus status) {
+        uint32_t row = (uint32_t)id;
+        Chunk* chunk = const_cast<Chunk*>(storedChunk(row));
+        if (chunk == nullptr || chunk->eventId[row & (CHUNK_ROWS - 1)] != (int32_t)(id >> 32)) return false;
+        chunk->status[row & (CHUNK_ROWS - 1)].store((uint8_t)status | STORED, memory_order_release);
+        return true;
+    }
+
+    // Price of a row, read from the price column alone (zero if the row is not stored)
+    Money priceAt(uint32_t row) const {
+        const Chunk* chunk = storedChunk(row);
+        return chunk != nullptr ? chunk->price[row & (CHUNK_ROWS - 1)] : Money();
+    }
+
+    // Calls f(ticket) for every stored ticket in row order, for the snapshot
+    template <typename F>
+    void forEach(F f) const {
+        uint32_t end = nextRow.load();
+        Ticket t;
+        for (uint32_t row = 1; row < end; ++row) {
+            const Chunk* chunk = storedChunk(row);
+            if (chunk != nullptr && get(Ticket::makeId(chunk->eventId[row & (CHUNK_ROWS - 1)], row), t)) f(t);
+        }
+    }
+
+    // Rows handed out so far
+    size_t size() const { return nextRow.load() - 1; }
+
+    // Bytes of the allocated chunks
+    size_t memoryUsage() const { return nChunks.load() * sizeof(Chunk); }
+};
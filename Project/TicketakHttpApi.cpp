@@ -0,0 +1,325 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
+#include "HttpServer.cpp"
+#include "Json.cpp"
+#include "TicketakService.cpp"
+
+using namespace std;
+
+// JSON endpoints over TicketakService, the handler given to HttpServer
+//
+//   POST /register           {"name","email","password","gender","phone"}
+//   POST /login              {"email","password","role":"fan"|"admin"} -> {"token"}
+//   POST /logout             (Authorization: Bearer <token>)
+//   GET  /events             all events
+//   GET  /events/search      ?name=<part of the name> or ?category=<Sports|Parties|Carnivals|Other>
+//   GET  /events/<id>
+//   POST /events/<id>/book   {"type":"VIP"|"Economic"|"Regular", "payment":"fawry"|"card", card fields}
+//   POST /events/<id>/hold   {"type"} -> {"hold","expiresIn"}, reserves one ticket for checkout
+//   POST /holds/<id>/confirm {"payment", card fields} -> the booked ticket
+//   POST /holds/<id>/release
+//   GET  /me/tickets         all of them, or one page with ?offset=<n>&limit=<n> (limit 1..1000, 100 by default)
+//   GET  /stats/expiry       progress of the background ticket expiry
+//
+// book and confirm take an optional Idempotency-Key header, a retry with the same key gets the first
+// answer back instead of a second ticket and charge.
+// Errors are {"error": message} with the matching status code.
+class TicketakHttpApi {
+public:
+    // Builds the payment strategy of a booking from its request fields (payment, cardholder, cardNumber, cvv, expiry)
+    using PaymentFactory = function<unique_ptr<PaymentMethod>(const vector<string>& fields)>;
+
+    explicit TicketakHttpApi(PaymentFactory paymentFactory = defaultPayment)
+        : service(TicketakService::getInstance()), paymentFactory(move(paymentFactory)) {}
+
+    static unique_ptr<PaymentMethod> defaultPayment(const vector<string>& fields) {
+        if (fields[0] == "card")
+            return unique_ptr<PaymentMethod>(new CreditCard(fields[1], fields[2], fields[3], fields[4]));
+        return unique_ptr<PaymentMethod>(new FawryPay());
+    }
+
+    HttpResponse handle(const HttpRequest& req) {
+        const string& path = req.path;
+        if (path == "/events" && req.method == "GET")
+            return ok(eventsJson(service.listEvents()));
+        if (path == "/events/search" && req.method == "GET")
+            return search(req);
+        if (path.compare(0, 8, "/events/") == 0)
+            return eventRoute(req);
+        if (path.compare(0, 7, "/holds/") == 0)
+            return holdRoute(req);
+        if (path == "/login" && req.method == "POST")
+            return login(req);
+        if (path == "/logout" && req.method == "POST") {
+            service.logout(bearerToken(req));
+            return ok("{}");
+        }
+        if (path == "/register" && req.method == "POST")
+            return registerFan(req);
+        if (path == "/me/tickets" && req.method == "GET")
+            return myTickets(req);
+        if (path == "/stats/expiry" && req.method == "GET")
+            return ok(expiryJson(service.expiryProgress()));
+        return error(404, "Not found");
+    }
+
+    // ---------- JSON ----------
+
+    static string expiryJson(const ExpiryProgress& p) {
+        return "{\"eventsQueued\":" + to_string(p.eventsQueued) + ",\"eventsSwept\":" + to_string(p.eventsSwept) +
+            ",\"ticketsExpired\":" + to_string(p.ticketsExpired) + ",\"batches\":" + to_string(p.batches) +
+            ",\"pending\":" + to_string(p.pending) + "}";
+    }
+
+    static string eventJson(const EventView& e) {
+        char date[16];
+        snprintf(date, sizeof(date), "%02d-%02d-%d", e.date.day, e.date.month, e.date.year);
+        string out = "{\"id\":" + to_string(e.id) + ",\"name\":" + Json::quote(e.name) +
+            ",\"category\":\"" + categoryName(e.category) + "\",\"date\":\"" + date +
+            "\",\"status\":\"" + (e.status == EventStatus::Finished ? "Finished" : "Upcoming") + "\",\"tickets\":{";
+        const pair<const char*, const TicketTypePriceQuantity*> tiers[] = {
+            {"VIP", &e.vip}, {"Economic", &e.economic}, {"Regular", &e.regular}
+        };
+        for (int i = 0; i < 3; ++i) {
+            if (i) out += ',';
+            out += string("\"") + tiers[i].first + "\":{\"price\":" + tiers[i].second->price.toString() +
+                ",\"available\":" + to_string(tiers[i].second->quantity) + "}";
+        }
+        return out + "}}";
+    }
+
+    static string eventsJson(const vector<EventView>& events) {
+        string out = "[";
+        for (size_t i = 0; i < events.size(); ++i) {
+            if (i) out += ',';
+            out += eventJson(events[i]);
+        }
+        return out + "]";
+    }
+
+    static string ticketJson(const Ticket& t) {
+        string out = "{\"id\":" + Json::quote(t.getIdStr()) + ",\"eventId\":" + to_string(t.getEventId()) +
+            ",\"type\":" + Json::quote(t.getType()) + ",\"price\":" + t.getPrice().toString() +
+            ",\"status\":" + Json::quote(t.getTicketStatusStr());
+        Seat seat = t.getSeat();
+        // numbered seats are 1-based for the client
+        if (seat.isAssigned())
+            out += ",\"seat\":{\"section\":" + to_string(seat.section + 1) + ",\"row\":" + to_string(seat.row + 1) +
+                ",\"number\":" + to_string(seat.number + 1) + "}";
+        return out + "}";
+    }
+
+private:
+    TicketakService& service;
+    PaymentFactory paymentFactory;
+
+    static const char* categoryName(Category category) {
+        switch (category) {
+            case Category::Sports: return "Sports";
+            case Category::Parties: return "Parties";
+            case Category::Carnivals: return "Carnivals";
+            case Category::Other: return "Other";
+            default: return "Unknown";
+        }
+    }
+
+    static HttpResponse ok(const string& body, int status = 200) {
+        return HttpResponse{status, body};
+    }
+
+    static HttpResponse error(int status, const string& message) {
+        return HttpResponse{status, "{\"error\":" + Json::quote(message) + "}"};
+    }
+
+    static HttpResponse fromStatus(ServiceStatus status, const string& message = "") {
+        int code;
+        switch (status) {
+            case ServiceStatus::InvalidCredentials:
+            case ServiceStatus::NotLoggedIn: code = 401; break;
+            case ServiceStatus::InvalidInput: code = 400; break;
+            case ServiceStatus::EventNotFound: code = 404; break;
+            case ServiceStatus::PaymentFailed: code = 402; break;
+            case ServiceStatus::HoldExpired: code = 410; break;
+            case ServiceStatus::KeyReused: code = 422; break;
+            case ServiceStatus::EmailInUse:
+            case ServiceStatus::EventFinished:
+            case ServiceStatus::SoldOut: code = 409; break;
+            default: code = 500;
+        }
+        return error(code, message.empty() ? TicketakService::statusToString(status) : message);
+    }
+
+    static string bearerToken(const HttpRequest& req) {
+        string auth = req.header("authorization");
+        return auth.compare(0, 7, "Bearer ") == 0 ? auth.substr(7) : "";
+    }
+
+    // Value of one query parameter, URL decoded
+    static string queryParam(const string& query, const string& name) {
+        size_t pos = 0;
+        while (pos <= query.size()) {
+            size_t end = query.find('&', pos);
+            if (end == string::npos) end = query.size();
+            size_t eq = query.find('=', pos);
+            if (eq != string::npos && eq < end && query.compare(pos, eq - pos, name) == 0 && eq - pos == name.size())
+                return urlDecode(query.substr(eq + 1, end - eq - 1));
+            pos = end + 1;
+        }
+        return "";
+    }
+
+    static string urlDecode(const string& s) {
+        string out;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '+') out += ' ';
+            else if (s[i] == '%' && i + 2 < s.size() && isxdigit((unsigned char)s[i + 1]) && isxdigit((unsigned char)s[i + 2])) {
+                out += (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+                i += 2;
+            } else {
+                out += s[i];
+            }
+        }
+        return out;
+    }
+
+    HttpResponse search(const HttpRequest& req) {
+        string name = queryParam(req.query, "name");
+        string category = queryParam(req.query, "category");
+        if (!category.empty()) {
+            for (Category c : {Category::Sports, Category::Parties, Category::Carnivals, Category::Other}) {
+                if (category == categoryName(c)) return ok(eventsJson(service.searchByCategory(c)));
+            }
+            return error(400, "Unknown category");
+        }
+        if (name.empty()) return error(400, "name or category is required");
+        return ok(eventsJson(service.searchByName(name)));
+    }
+
+    static bool parseType(const string& name, TicketType& type) {
+        if (name == "VIP") type = TicketType::VIP;
+        else if (name == "Economic") type = TicketType::Economic;
+        else if (name == "Regular") type = TicketType::Regular;
+        else return false;
+        return true;
+    }
+
+    // /events/<id>, /events/<id>/book and /events/<id>/hold
+    HttpResponse eventRoute(const HttpRequest& req) {
+        string rest = req.path.substr(8);
+        size_t slash = rest.find('/');
+        string idPart = rest.substr(0, slash);
+        string action = slash == string::npos ? "" : rest.substr(slash + 1);
+        char* end;
+        long id = strtol(idPart.c_str(), &end, 10);
+        if (idPart.empty() || *end != '\0') return error(404, "Not found");
+
+        if (action.empty()) {
+            if (req.method != "GET") return error(405, "Method not allowed");
+            EventView view;
+            ServiceStatus status = service.getEvent((int)id, view);
+            return status == ServiceStatus::Ok ? ok(eventJson(view)) : fromStatus(status);
+        }
+        if (action != "book" && action != "hold") return error(404, "Not found");
+        if (req.method != "POST") return error(405, "Method not allowed");
+
+        vector<string> fields;
+        if (!Json::parseFlatObject(req.body, {"type", "payment", "cardholder", "cardNumber", "cvv", "expiry"}, fields))
+            return error(400, "Malformed JSON");
+        TicketType type;
+        if (!parseType(fields[0], type)) return error(400, "type must be VIP, Economic or Regular");
+
+        if (action == "hold") {
+            uint64_t holdId;
+            ServiceStatus status = service.reserveTicket(bearerToken(req), (int)id, type, holdId);
+            if (status != ServiceStatus::Ok) return fromStatus(status);
+            long long seconds = chrono::duration_cast<chrono::seconds>(service.getReservationTtl()).count();
+            return ok("{\"hold\":\"" + to_string(holdId) + "\",\"expiresIn\":" + to_string(seconds) + "}", 201);
+        }
+
+        unique_ptr<PaymentMethod> payment = paymentFactory(vector<string>(fields.begin() + 1, fields.end()));
+        Ticket ticket;
+        ServiceStatus status = service.bookTicket(bearerToken(req), (int)id, type, *payment, ticket,
+                                                  req.header("idempotency-key"));
+        return status == ServiceStatus::Ok ? ok(ticketJson(ticket), 201) : fromStatus(status);
+    }
+
+    // /holds/<id>/confirm and /holds/<id>/release
+    HttpResponse holdRoute(const HttpRequest& req) {
+        string rest = req.path.substr(7);
+        size_t slash = rest.find('/');
+        if (slash == string::npos || slash == 0) return error(404, "Not found");
+        string idPart = rest.substr(0, slash);
+        string action = rest.substr(slash + 1);
+        char* end;
+        uint64_t holdId = strtoull(idPart.c_str(), &end, 10);
+        if (*end != '\0') return error(404, "Not found");
+        if (action != "confirm" && action != "release") return error(404, "Not found");
+        if (req.method != "POST") return error(405, "Method not allowed");
+
+        if (action == "release") {
+            ServiceStatus status = service.cancelReservation(bearerToken(req), holdId);
+            return status == ServiceStatus::Ok ? ok("{}") : fromStatus(status);
+        }
+        vector<string> fields;
+        if (!Json::parseFlatObject(req.body, {"payment", "cardholder", "cardNumber", "cvv", "expiry"}, fields))
+            return error(400, "Malformed JSON");
+        unique_ptr<PaymentMethod> payment = paymentFactory(fields);
+        Ticket ticket;
+        ServiceStatus status = service.confirmReservation(bearerToken(req), holdId, *payment, ticket,
+                                                          req.header("idempotency-key"));
+        return status == ServiceStatus::Ok ? ok(ticketJson(ticket), 201) : fromStatus(status);
+    }
+
+    HttpResponse login(const HttpRequest& req) {
+        vector<string> fields;
+        if (!Json::parseFlatObject(req.body, {"email", "password", "role"}, fields))
+            return error(400, "Malformed JSON");
+        UserType type = fields[2] == "admin" ? UserType::Admin : UserType::Fan;
+        string token;
+        ServiceStatus status = service.login(LoginDTO{fields[0], fields[1]}, type, token);
+        return status == ServiceStatus::Ok ? ok("{\"token\":" + Json::quote(token) + "}") : fromStatus(status);
+    }
+
+    HttpResponse registerFan(const HttpRequest& req) {
+        vector<string> fields;
+        if (!Json::parseFlatObject(req.body, {"name", "email", "password", "gender", "phone"}, fields))
+            return error(400, "Malformed JSON");
+        string message;
+        ServiceStatus status = service.registerFan(
+            Fan(fields[0], fields[1], fields[2], fields[3].empty() ? ' ' : fields[3][0], fields[4]), message);
+        return status == ServiceStatus::Ok ? ok("{}", 201) : fromStatus(status, message);
+    }
+
+    HttpResponse myTickets(const HttpRequest& req) {
+        vector<Ticket> tickets;
+        string offset = queryParam(req.query, "offset"), limit = queryParam(req.query, "limit");
+        ServiceStatus status;
+        if (offset.empty() && limit.empty()) {
+            status = service.myTickets(bearerToken(req), tickets);
+        } else {
+            char* end1;
+            char* end2;
+            long from = offset.empty() ? 0 : strtol(offset.c_str(), &end1, 10);
+            long count = limit.empty() ? 100 : strtol(limit.c_str(), &end2, 10);
+            if ((!offset.empty() && *end1 != '\0') || (!limit.empty() && *end2 != '\0') || from < 0 || count <= 0 ||
+                count > 1000)
+                return error(400, "Invalid offset or limit");
+            status = service.myTickets(bearerToken(req), (size_t)from, (size_t)count, tickets);
+        }
+        if (status != ServiceStatus::Ok) return fromStatus(status);
+        string out = "[";
+        for (size_t i = 0; i < tickets.size(); ++i) {
+            if (i) out += ',';
+            out += ticketJson(tickets[i]);
+        }
+        return ok(out + "]");
+    }
+};
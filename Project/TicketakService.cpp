@@ -0,0 +1,538 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <condition_variable>
+
+#include "EventManager.cpp"
+#include "FanManager.cpp"
+#include "AdminManager.cpp"
+#include "StorageManager.cpp"
+#include "ValidationService.cpp"
+#include "AuthenticationService.cpp"
+#include "PaymentService.cpp"
+#include "PaymentGateway.cpp"
+#include "PaymentPipeline.cpp"
+#include "BookingShards.cpp"
+#include "CheckoutHolds.cpp"
+#include "TicketExpirySweeper.cpp"
+#include "IdempotencyTable.cpp"
+
+using namespace std;
+
+enum class ServiceStatus {
+    Ok = 0,
+    InvalidCredentials,
+    InvalidInput,      // the message out-parameter says which rule failed
+    EmailInUse,
+    NotLoggedIn,       // unknown token, or the session is not a fan's
+    EventNotFound,
+    EventFinished,
+    SoldOut,
+    PaymentFailed,
+    HoldExpired,       // the reservation timed out (or was never made), its tickets are back on sale
+    KeyReused          // the idempotency key was already used for a different request
+};
+
+// Read-only copy of the fields a client shows, without the event's tickets log
+struct EventView {
+    int id = 0;
+    string name;
+    Category category = Category::Other;
+    Date date{};
+    EventStatus status = EventStatus::Upcoming;
+    TicketTypePriceQuantity vip{}, economic{}, regular{};
+
+    EventView() = default;
+    explicit EventView(const Event& e)
+        : id(e.getId()), name(e.getName()), category(e.getCategory()),
+          date{e.getDay(), e.getMonth(), e.getYear()}, status(e.getEventStatus()),
+          vip(e.getVipTickets()), economic(e.getEconomicTickets()), regular(e.getRegularTickets()) {}
+
+    string viewDetailsBreifly() const {
+        return Event::viewDetailsBreifly(id, name, category, date);
+    }
+};
+
+// Headless API over the managers, no console I/O. The console UI (SystemManager) is one client of it,
+// the load generator another. Every call is safe from many threads: manager lookups and inserts are
+// serialized by one mutex, while ticket booking runs on the event's BookingShards shard outside it,
+// its payment on the PaymentPipeline and its log record goes through StorageManager's group commit.
+// Clients change events and fans only through this API too, so the background threads that look
+// them up (status clock, holds, expiry, shards) never see a manager mid-change.
+class TicketakService {
+private:
+    struct Session {
+        UserType type = UserType::NotAuth;
+        User* user = nullptr;
+    };
+
+    mutex managersMutex;
+    unordered_map<string, Session> sessions;
+    mt19937_64 tokenSource{random_device{}()};
+
+    // Payments settle on the pipeline's workers, in-process through each strategy's pay()
+    DirectGateway gateway;
+    PaymentPipeline payments{gateway};
+
+    // Bookings are routed to the shard owning the event, a shard resolves an event under managersMutex
+    // and again after any event is deleted; deleteEvent goes through the shard so it waits for them
+    BookingShards shards{[this](int eventId) {
+        lock_guard<mutex> lock(managersMutex);
+        return EventManager::getInstance().getEvent(eventId);
+    }, thread::hardware_concurrency(), &payments, [] { return EventManager::getInstance().getGeneration(); }};
+
+    // Tickets reserved by fans while they check out, given back by the expiry thread after the TTL
+    CheckoutHolds holds{[this](int eventId, const function<void(Event&)>& use) {
+        lock_guard<mutex> lock(managersMutex);
+        Event* e = EventManager::getInstance().getEvent(eventId);
+        if (e != nullptr) use(*e);
+    }};
+
+    // Answer of a booking or payment call, kept per idempotency key so a retry gets it back
+    struct TicketReply {
+        ServiceStatus status = ServiceStatus::Ok;
+        Ticket ticket;
+    };
+    IdempotencyTable<TicketReply> ticketReplies;
+
+    // Expires the tickets of the events the status clock finishes, on its own thread
+    TicketExpirySweeper expiry{[this](int eventId) {
+        lock_guard<mutex> lock(managersMutex);
+        Event* e = EventManager::getInstance().getEvent(eventId);
+        return e != nullptr && e->getEventStatus() == EventStatus::Finished ? e->getTicketIds() : vector<uint64_t>();
+    }};
+
+    // Finishes events as their dates pass, one EventManager::updateStatuses a minute
+    mutex clockMutex;
+    condition_variable clockWake;
+    bool clockStopping = false;
+    thread statusClock;
+
+    // Private constructor
+    TicketakService() {
+        // Statics are destroyed in reverse order of construction: the singletons the background
+        // threads use are built here, before the service is, so they outlive its threads at exit
+        TicketStore::getInstance();
+        EventManager::getInstance();
+        FanManager::getInstance();
+        AdminManager::getInstance();
+        StorageManager::getInstance();
+        holds.start();
+        expiry.start();
+        // first tick here: events restored with a past date get their tickets expired now
+        tickStatuses();
+        statusClock = thread([this] { runStatusClock(); });
+    }
+
+    ~TicketakService() {
+        {
+            lock_guard<mutex> lock(clockMutex);
+            clockStopping = true;
+        }
+        clockWake.notify_all();
+        statusClock.join();
+    }
+
+    void runStatusClock() {
+        unique_lock<mutex> lock(clockMutex);
+        while (!clockWake.wait_for(lock, chrono::minutes(1), [this] { return clockStopping; })) {
+            tickStatuses();
+        }
+    }
+
+    void tickStatuses() {
+        vector<int> finished;
+        {
+            lock_guard<mutex> lock(managersMutex);
+            EventManager::getInstance().updateStatuses(&finished);
+        }
+        expiry.enqueue(finished);
+    }
+
+    // Disable copy & assignment
+    TicketakService(const TicketakService&) = delete;
+    TicketakService& operator=(const TicketakService&) = delete;
+
+    // Caller holds managersMutex
+    string newToken() {
+        static const char hex[] = "0123456789abcdef";
+        string token;
+        for (int part = 0; part < 2; ++part) {
+            uint64_t bits = tokenSource();
+            for (int i = 0; i < 16; ++i, bits >>= 4) token += hex[bits & 0xF];
+        }
+        return token;
+    }
+
+    // Caller holds managersMutex
+    Fan* sessionFan(const string& token) {
+        auto it = sessions.find(token);
+        if (it == sessions.end() || it->second.type != UserType::Fan) return nullptr;
+        return static_cast<Fan*>(it->second.user);
+    }
+
+    // Runs a booking or payment call once per (fan, key), a repeat gets the first call's answer
+    // An empty key runs it every time
+    ServiceStatus once(const Fan* fan, const string& idempotencyKey, const string& fingerprint,
+                       Ticket& ticket, const function<ServiceStatus(Ticket&)>& call) {
+        if (idempotencyKey.empty()) return call(ticket);
+        TicketReply reply;
+        IdempotencyOutcome outcome = ticketReplies.run(to_string(fan->getId()) + ":" + idempotencyKey, fingerprint, reply,
+            [&call] {
+                TicketReply first;
+                first.status = call(first.ticket);
+                return first;
+            });
+        if (outcome == IdempotencyOutcome::Conflict) return ServiceStatus::KeyReused;
+        ticket = reply.ticket;
+        return reply.status;
+    }
+
+    template <typename Events>
+    static vector<EventView> toViews(const Events& events) {
+        vector<EventView> views;
+        views.reserve(events.size());
+        for (const Event* e : events) views.emplace_back(*e);
+        return views;
+    }
+
+public:
+    static TicketakService& getInstance() {
+        static TicketakService instance; // Magic Static
+        return instance;
+    }
+
+    // ---------- Accounts ----------
+
+    // Opens a session, the token is passed to the calls that act for the user
+    ServiceStatus login(const LoginDTO& credentials, UserType userType, string& token) {
+        lock_guard<mutex> lock(managersMutex);
+        User* user = AuthenticationService::login(credentials, userType);
+        if (user == nullptr) return ServiceStatus::InvalidCredentials;
+        token = newToken();
+        sessions[token] = Session{userType, user};
+        return ServiceStatus::Ok;
+    }
+
+    void logout(const string& token) {
+        lock_guard<mutex> lock(managersMutex);
+        sessions.erase(token);
+    }
+
+    // The user behind a session, nullptr for an unknown token
+    // Note: the pointer is owned by FanManager/AdminManager
+    User* getUser(const string& token) {
+        lock_guard<mutex> lock(managersMutex);
+        auto it = sessions.find(token);
+        return it == sessions.end() ? nullptr : it->second.user;
+    }
+
+    // Same rules as the register form, message names the first one that failed
+    ServiceStatus registerFan(Fan fan, string& message) {
+        if (!ValidationService::isValidEmail(fan.getEmail())) {
+            message = "Email is not valid.";
+            return ServiceStatus::InvalidInput;
+        }
+        if (!ValidationService::isValidUserName(fan.getName())) {
+            message = "The Name Should be from 4 to 20 characters.";
+            return ServiceStatus::InvalidInput;
+        }
+        if (!ValidationService::isValidPassword(fan.getPassword())) {
+            message = "The Password Should be at least 8 characters.";
+            return ServiceStatus::InvalidInput;
+        }
+
+        StorageManager::ChangeGuard change(StorageManager::getInstance());
+        {
+            lock_guard<mutex> lock(managersMutex);
+            if (AuthenticationService::isExistingEmail(fan.getEmail())) {
+                message = "Email is already in use.";
+                return ServiceStatus::EmailInUse;
+            }
+            AuthenticationService::_register(fan);
+        }
+        StorageManager::getInstance().logAddFan(fan);
+        return ServiceStatus::Ok;
+    }
+
+    bool isEmailInUse(const string& email) {
+        lock_guard<mutex> lock(managersMutex);
+        return AuthenticationService::isExistingEmail(email);
+    }
+
+    // ---------- Events ----------
+
+    vector<EventView> listEvents() {
+        lock_guard<mutex> lock(managersMutex);
+        return toViews(EventManager::getInstance().getEvents());
+    }
+
+    ServiceStatus getEvent(int eventId, EventView& view) {
+        lock_guard<mutex> lock(managersMutex);
+        Event* e = EventManager::getInstance().getEvent(eventId);
+        if (e == nullptr) return ServiceStatus::EventNotFound;
+        view = EventView(*e);
+        return ServiceStatus::Ok;
+    }
+
+    // The event's details text, with its revenue so far when asked for (an admin's view)
+    ServiceStatus getEventDetails(int eventId, string& details, Money* revenue = nullptr) {
+        lock_guard<mutex> lock(managersMutex);
+        Event* e = EventManager::getInstance().getEvent(eventId);
+        if (e == nullptr) return ServiceStatus::EventNotFound;
+        details = e->viewDetails();
+        if (revenue != nullptr) *revenue = e->getRevenue();
+        return ServiceStatus::Ok;
+    }
+
+    vector<EventView> searchByName(const string& name) {
+        lock_guard<mutex> lock(managersMutex);
+        EventManager& eventManager = EventManager::getInstance();
+        vector<EventView> views;
+        for (int eventId : eventManager.searchByName(name)) {
+            views.emplace_back(*eventManager.getEvent(eventId));
+        }
+        return views;
+    }
+
+    // In date order
+    vector<EventView> searchByCategory(Category category) {
+        lock_guard<mutex> lock(managersMutex);
+        EventManager& eventManager = EventManager::getInstance();
+        vector<EventView> views;
+        for (int eventId : eventManager.getEventsByCategory(category)) {
+            views.emplace_back(*eventManager.getEvent(eventId));
+        }
+        return views;
+    }
+
+    // Runs f with managersMutex held, for a client that reads the managers directly (the console's ticket pages)
+    // Note: f must copy out what it needs, an event deleted once the lock is released reuses its slot
+    template <typename F>
+    auto withManagers(F f) -> decltype(f()) {
+        lock_guard<mutex> lock(managersMutex);
+        return f();
+    }
+
+    // ---------- Admin ----------
+
+    // Adds the event and assigns it its id
+    void createEvent(Event& event) {
+        StorageManager::ChangeGuard change(StorageManager::getInstance());
+        {
+            lock_guard<mutex> lock(managersMutex);
+            EventManager::getInstance().addEvent(event);
+        }
+        StorageManager::getInstance().logAddEvent(event);
+    }
+
+    // Saves an edited copy of an event (e.g. one filled from getEvent's view) over the event
+    ServiceStatus editEvent(const Event& edited) {
+        StorageManager::ChangeGuard change(StorageManager::getInstance());
+        {
+            lock_guard<mutex> lock(managersMutex);
+            EventManager& eventManager = EventManager::getInstance();
+            Event* e = eventManager.getEvent(edited.getId());
+            if (e == nullptr) return ServiceStatus::EventNotFound;
+            e->applyEdit(edited);
+            eventManager.reindexEvent(*e);
+        }
+        StorageManager::getInstance().logEditEvent(edited);
+        return ServiceStatus::Ok;
+    }
+
+    // Waits for the event's bookings that are running (their shard holds its Event*), new ones are refused
+    ServiceStatus deleteEvent(int eventId) {
+        StorageManager::ChangeGuard change(StorageManager::getInstance());
+        bool deleted = shards.closeEvent(eventId, [this, eventId] {
+            lock_guard<mutex> lock(managersMutex);
+            return EventManager::getInstance().deleteEvent(eventId);
+        });
+        if (!deleted) return ServiceStatus::EventNotFound;
+        StorageManager::getInstance().logDeleteEvent(eventId);
+        return ServiceStatus::Ok;
+    }
+
+    // Folds the log into a fresh snapshot, between changes and with the managers locked
+    bool checkpoint() {
+        return StorageManager::getInstance().checkpoint(&managersMutex);
+    }
+
+    // ---------- Tickets ----------
+
+    // Holds one ticket of the type for the session's fan, pays with the given method, then books it
+    // Runs on the shard owning the event and the payment pipeline, the caller waits for both
+    // (managersMutex is not held meanwhile)
+    // A client that may retry sends an idempotency key: a repeat of the key returns the first
+    // answer (the same ticket, or the same failure) without booking or charging again.
+    ServiceStatus bookTicket(const string& token, int eventId, TicketType type, PaymentMethod& payment, Ticket& ticket,
+                             const string& idempotencyKey = "") {
+        Fan* fan;
+        {
+            lock_guard<mutex> lock(managersMutex);
+            fan = sessionFan(token);
+            if (fan == nullptr) return ServiceStatus::NotLoggedIn;
+        }
+        return once(fan, idempotencyKey, "book/" + to_string(eventId) + "/" + to_string((int)type), ticket,
+            [&](Ticket& booked) { return bookForFan(fan, eventId, type, payment, booked); });
+    }
+
+    // Pays for a reservation and books its ticket at the price it was reserved at
+    // A failed payment gives the ticket back, the fan has to reserve again
+    // Repeats of an idempotency key return the first answer, as for bookTicket
+    ServiceStatus confirmReservation(const string& token, uint64_t holdId, PaymentMethod& payment, Ticket& ticket,
+                                     const string& idempotencyKey = "") {
+        Fan* fan;
+        {
+            lock_guard<mutex> lock(managersMutex);
+            fan = sessionFan(token);
+            if (fan == nullptr) return ServiceStatus::NotLoggedIn;
+        }
+        return once(fan, idempotencyKey, "confirm/" + to_string(holdId), ticket,
+            [&](Ticket& booked) { return confirmForFan(fan, holdId, payment, booked); });
+    }
+
+private:
+    ServiceStatus bookForFan(Fan* fan, int eventId, TicketType type, PaymentMethod& payment, Ticket& ticket) {
+        // from the shard booking the ticket until the fan has it
+        StorageManager::ChangeGuard change(StorageManager::getInstance());
+        BookingResult result = shards.book(eventId, fan->getId(), type, payment);
+        switch (result.outcome) {
+            case BookingOutcome::EventNotFound: return ServiceStatus::EventNotFound;
+            case BookingOutcome::EventFinished: return ServiceStatus::EventFinished;
+            case BookingOutcome::PaymentFailed: return ServiceStatus::PaymentFailed;
+            case BookingOutcome::SoldOut: return ServiceStatus::SoldOut;
+            case BookingOutcome::Booked: break;
+        }
+
+        ticket = result.ticket;
+        StorageManager::getInstance().logBookEvent(ticket);
+        lock_guard<mutex> lock(managersMutex);
+        fan->buyTicket(ticket);
+        return ServiceStatus::Ok;
+    }
+
+    // The event is used only under managersMutex: it may be deleted while the payment runs,
+    // a charge that then finds it gone (or cannot be booked) is refunded
+    ServiceStatus confirmForFan(Fan* fan, uint64_t holdId, PaymentMethod& payment, Ticket& ticket) {
+        HeldTickets held;
+        if (!holds.take(holdId, fan->getId(), held)) return ServiceStatus::HoldExpired;
+        {
+            // deleted since the reservation, its held tickets went with it
+            lock_guard<mutex> lock(managersMutex);
+            if (EventManager::getInstance().getEvent(held.eventId) == nullptr) return ServiceStatus::EventNotFound;
+        }
+
+        if (!payments.submit(&payment, held.typePrice.price).get()) {
+            holds.giveBack(held);
+            return ServiceStatus::PaymentFailed;
+        }
+        StorageManager::ChangeGuard change(StorageManager::getInstance());
+        ServiceStatus status = ServiceStatus::Ok;
+        vector<Ticket> booked;
+        {
+            lock_guard<mutex> lock(managersMutex);
+            Event* event = EventManager::getInstance().getEvent(held.eventId);
+            if (event == nullptr) {
+                status = ServiceStatus::EventNotFound;
+            } else {
+                booked = event->bookHeldSeats(fan->getId(), held.typePrice, held.range);
+                if (booked.empty()) {
+                    event->releaseSeats(held.typePrice.type, held.range);
+                    status = ServiceStatus::SoldOut;
+                }
+            }
+        }
+        if (status != ServiceStatus::Ok) {
+            payments.refund(&payment, held.typePrice.price);
+            return status;
+        }
+        ticket = booked[0];
+        StorageManager::getInstance().logBookEvent(ticket);
+        lock_guard<mutex> lock(managersMutex);
+        fan->buyTicket(ticket);
+        return ServiceStatus::Ok;
+    }
+
+public:
+
+    // Reservation step of a checkout: holds one ticket of the type for the session's fan before
+    // payment, so a fan who pays can never lose the ticket to another buyer meanwhile.
+    // The hold is given back by itself unless confirmed or cancelled within getReservationTtl().
+    ServiceStatus reserveTicket(const string& token, int eventId, TicketType type, uint64_t& holdId) {
+        // the tickets are held with the event locked, a delete cannot reuse its slot meanwhile
+        lock_guard<mutex> lock(managersMutex);
+        Fan* fan = sessionFan(token);
+        if (fan == nullptr) return ServiceStatus::NotLoggedIn;
+        Event* event = EventManager::getInstance().getEvent(eventId);
+        if (event == nullptr) return ServiceStatus::EventNotFound;
+        if (event->getEventStatus() == EventStatus::Finished) return ServiceStatus::EventFinished;
+
+        TicketTypePrice typePrice{type, Money()};
+        switch (type) {
+            case TicketType::VIP: typePrice.price = event->getVipTickets().price; break;
+            case TicketType::Economic: typePrice.price = event->getEconomicTickets().price; break;
+            case TicketType::Regular: typePrice.price = event->getRegularTickets().price; break;
+        }
+        holdId = holds.hold(*event, fan->getId(), typePrice);
+        return holdId == CheckoutHolds::NO_HOLD ? ServiceStatus::SoldOut : ServiceStatus::Ok;
+    }
+
+    // Gives a reserved ticket back before its TTL, e.g. the fan left the checkout
+    ServiceStatus cancelReservation(const string& token, uint64_t holdId) {
+        Fan* fan;
+        {
+            lock_guard<mutex> lock(managersMutex);
+            fan = sessionFan(token);
+            if (fan == nullptr) return ServiceStatus::NotLoggedIn;
+        }
+        return holds.release(holdId, fan->getId()) ? ServiceStatus::Ok : ServiceStatus::HoldExpired;
+    }
+
+    chrono::milliseconds getReservationTtl() const {
+        return holds.getTtl();
+    }
+
+    // Counters of the background ticket expiry
+    ExpiryProgress expiryProgress() { return expiry.progress(); }
+
+    ServiceStatus myTickets(const string& token, vector<Ticket>& tickets) {
+        lock_guard<mutex> lock(managersMutex);
+        Fan* fan = sessionFan(token);
+        if (fan == nullptr) return ServiceStatus::NotLoggedIn;
+        tickets = fan->getMyTickets();
+        return ServiceStatus::Ok;
+    }
+
+    // Tickets [from, from + count) of the fan in purchase order
+    ServiceStatus myTickets(const string& token, size_t from, size_t count, vector<Ticket>& tickets) {
+        lock_guard<mutex> lock(managersMutex);
+        Fan* fan = sessionFan(token);
+        if (fan == nullptr) return ServiceStatus::NotLoggedIn;
+        tickets = fan->getMyTickets(from, count);
+        return ServiceStatus::Ok;
+    }
+
+    static string statusToString(ServiceStatus status) {
+        switch (status) {
+            case ServiceStatus::Ok: return "Ok";
+            case ServiceStatus::InvalidCredentials: return "Your credentials are wrong";
+            case ServiceStatus::InvalidInput: return "Invalid input";
+            case ServiceStatus::EmailInUse: return "Email is already in use";
+            case ServiceStatus::NotLoggedIn: return "Not logged in as a fan";
+            case ServiceStatus::EventNotFound: return "Event not found";
+            case ServiceStatus::EventFinished: return "This Event is already Finished";
+            case ServiceStatus::SoldOut: return "Unavailable tickets";
+            case ServiceStatus::PaymentFailed: return "Payment failed";
+            case ServiceStatus::HoldExpired: return "Your reservation has expired";
+            case ServiceStatus::KeyReused: return "Idempotency key was used for another request";
+            default: return "Unknown";
+        }
+    }
+};
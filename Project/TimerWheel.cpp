@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Hierarchical timing wheel: 4 levels of 256 slots, level L slot covers 256^L ticks.
+// A timer goes into the lowest level whose span reaches its expiry; when level 0 wraps, the due
+// slot of level 1 is poured back into level 0 (and so on up), so each timer moves down at most
+// three times over its life. Scheduling and cancelling are O(1), a tick costs O(1) plus the
+// timers it fires, whatever the number of outstanding timers.
+//
+// Timers live in one node pool linked by index (no allocation per timer once the pool has grown),
+// an id is [generation : 32][node index : 32] so a stale id never cancels a reused node.
+// Not thread safe, the owner serializes calls.
+class TimerWheel {
+public:
+    using TimerId = uint64_t;
+    static constexpr TimerId NO_TIMER = 0;
+    // longer delays are clamped
+    static constexpr uint64_t MAX_DELAY = (1ull << 32) - 1;
+
+    explicit TimerWheel(uint64_t startTick = 0) : now(startTick) {
+        for (auto& level : slots) {
+            for (uint32_t& head : level) head = NIL;
+        }
+    }
+
+    uint64_t currentTick() const { return now; }
+
+    size_t size() const { return active; }
+
+    // Fires payload once the wheel has advanced past now + delay
+    TimerId schedule(uint64_t delay, uint64_t payload) {
+        uint32_t index;
+        if (freeHead != NIL) {
+            index = freeHead;
+            freeHead = nodes[index].next;
+        } else {
+            index = (uint32_t)nodes.size();
+            nodes.push_back(Node());
+        }
+        Node& node = nodes[index];
+        node.expires = now + (delay > MAX_DELAY ? MAX_DELAY : delay);
+        node.payload = payload;
+        node.scheduled = true;
+        link(index);
+        active++;
+        return ((TimerId)node.generation << 32) | index;
+    }
+
+    // false if the timer already fired or was cancelled
+    bool cancel(TimerId id) {
+        uint32_t index = (uint32_t)id;
+        if (index >= nodes.size() || nodes[index].generation != (uint32_t)(id >> 32) || !nodes[index].scheduled)
+            return false;
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // Processes every tick before target, calling onExpire(payload) for each timer that fires
+    template <typename OnExpire>
+    size_t advanceTo(uint64_t target, OnExpire onExpire) {
+        size_t fired = 0;
+        while (now < target) {
+            if (active == 0) {
+                now = target;
+                break;
+            }
+            uint32_t index0 = now & MASK;
+            // level 0 wrapped: pour the due slot of each level above into the levels below
+            for (int level = 1; level < LEVELS && (now >> (BITS * (level - 1)) & MASK) == 0; ++level) {
+                cascade(level, (now >> (BITS * level)) & MASK);
+            }
+            uint32_t index = slots[0][index0];
+            slots[0][index0] = NIL;
+            while (index != NIL) {
+                uint32_t next = nodes[index].next;
+                uint64_t payload = nodes[index].payload;
+                release(index);
+                onExpire(payload);
+                fired++;
+                index = next;
+            }
+            now++;
+        }
+        return fired;
+    }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int BITS = 8;
+    static constexpr uint32_t MASK = (1u << BITS) - 1;
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        uint64_t expires = 0;
+        uint64_t payload = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t generation = 1;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool scheduled = false;
+    };
+
+    vector<Node> nodes;
+    uint32_t freeHead = NIL;
+    size_t active = 0;
+    uint64_t now;
+    uint32_t slots[LEVELS][1u << BITS];
+
+    void link(uint32_t index) {
+        Node& node = nodes[index];
+        uint64_t delta = node.expires - now;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (1ull << (BITS * (level + 1)))) level++;
+        node.level = (uint8_t)level;
+        node.slot = (uint8_t)((node.expires >> (BITS * level)) & MASK);
+        uint32_t& head = slots[level][node.slot];
+        node.prev = NIL;
+        node.next = head;
+        if (head != NIL) nodes[head].prev = index;
+        head = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes[index];
+        if (node.prev != NIL) nodes[node.prev].next = node.next;
+        else slots[node.level][node.slot] = node.next;
+        if (node.next != NIL) nodes[node.next].prev = node.prev;
+    }
+
+    // Back to the free list, the next schedule of this node gets a new generation
+    void release(uint32_t index) {
+        Node& node = nodes[index];
+        node.scheduled = false;
+        node.generation++;
+        node.next = freeHead;
+        freeHead = index;
+        active--;
+    }
+
+    void cascade(int level, uint32_t slot) {
+        uint32_t index = slots[level][slot];
+        slots[level][slot] = NIL;
+        while (index != NIL) {
+            uint32_t next = nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+};
@@ -0,0 +1,61 @@
+// Per-call latency of the email and phone validators against the std::regex they replaced
+// The regex side builds its pattern on every call, as ValidationService did. Exits non-zero if a
+// validator and its regex disagree on any sample.
+//
+//   ticketak-validation-bench [--rounds 20000]
+
+#include <chrono>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "Validators.cpp"
+
+using namespace std;
+
+static string argValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+static bool regexEmail(const string& s) {
+    regex stdEmail("[^@.]+(.[^@.]+)?(@[A-Za-z0-9]+)(\\-[A-Za-z0-9]+)?(.[0-9]*[A-Za-z]+[0-9]*(\\-[A-Za-z0-9]+)?)+");
+    return regex_match(s, stdEmail);
+}
+
+static bool regexPhone(const string& s) {
+    regex stdPhoneNum("(010|011|012|015)[0-9]{8}");
+    return regex_match(s, stdPhoneNum);
+}
+
+int main(int argc, char* argv[]) {
+    const int rounds = stoi(argValue(argc, argv, "--rounds", "20000"));
+    const vector<string> emails = {
+        "ahmed.reda@ticketak.com", "fan_01@mail.iti.gov.eg", "no-at-sign.com", "a@b", "karim@ticketak-iti.org"
+    };
+    const vector<string> phones = {"01065246880", "01512345678", "0136524688", "0106524688x", "02065246880"};
+
+    auto timeIt = [&](const string& label, const vector<string>& inputs, bool (*check)(const string&)) {
+        int valid = 0;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            for (const string& s : inputs) valid += check(s);
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        cout << label << ": " << ns / (rounds * inputs.size()) << " ns/call (" << valid << " valid)\n";
+    };
+
+    timeIt("email std::regex ", emails, regexEmail);
+    timeIt("email Validators ", emails, [](const string& s) { return Validators::isEmail(s); });
+    timeIt("phone std::regex ", phones, regexPhone);
+    timeIt("phone Validators ", phones, [](const string& s) { return Validators::isEgyptianPhone(s); });
+
+    bool ok = true;
+    for (const string& s : emails) ok = ok && Validators::isEmail(s) == regexEmail(s);
+    for (const string& s : phones) ok = ok && Validators::isEgyptianPhone(s) == regexPhone(s);
+    cout << (ok ? "validators agree with the regexes" : "validators DISAGREE with the regexes") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Event.cpp"
+#include "Validators.cpp"
+
+using namespace std;
+
+class ValidationService {
+public:
+    static bool isValidEmail(const string &email) {
+        // A Form of E-mail following IETF standards, matched by a precompiled automaton (see Validators.cpp)
+        return Validators::isEmail(email);
+    }
+
+    static bool isValidNum(const string &phoneNum) {
+        // Standard form of Egyptian phone number
+        return Validators::isEgyptianPhone(phoneNum);
+    }
+
+    // Batch validation of a column of inputs (e.g. an import), returns how many are valid
+    static size_t areValidEmails(const vector<string> &emails, vector<bool> &results) {
+        return Validators::areEmails(emails, results);
+    }
+
+    static size_t areValidNums(const vector<string> &phoneNums, vector<bool> &results) {
+        return Validators::areEgyptianPhones(phoneNums, results);
+    }
+
+    static bool isValidUserName(const string &userName) {
+        // User name should contain 4 to 20 characters
+        return (userName.size() <= 20 && userName.size() >= 3);
+    }
+
+    static bool isValidPassword(const string &password) {
+        return (password.size() >= 8);
+    }
+
+    static int isValidEvent(Event& e,string &error) {
+        int errC = 0;
+        if (e.getName().empty()) {
+            error = "Event name cannot be empty";
+            errC++;
+        }
+        
+        if (e.getDay() < 1 || e.getDay() > 31) {
+            if (!error.empty()) error += '\n';
+            error += "Invalid day";
+            errC++;
+        }
+        
+        if (e.getMonth() < 1 || e.getMonth() > 12) {
+            if (!error.empty()) error += '\n';
+            error += "Invalid month";
+            errC++;
+        }
+        
+        if (e.getYear() < 2025) {
+            if (!error.empty()) error += '\n';
+            error += "Invalid year";
+            errC++;
+        }
+
+        if (e.getEventStatus() == EventStatus::Finished) {
+            if (!error.empty()) error += '\n';
+            error += "Date Shouldn't be in the past";
+            errC++;
+        }
+
+        const auto& vipTickets = e.getVipTickets();
+        if (vipTickets.quantity < 0) {
+            if (!error.empty()) error += '\n';
+            error += "VIP tickets quantity must be greater than or equal to zero";
+            errC++;
+        }
+
+        if (vipTickets.quantity > 0 && vipTickets.price <= Money()) {
+            if (!error.empty()) error += '\n';
+            error += "VIP tickets price must be greater than zero";
+            errC++;
+        }
+
+        const auto& regularTickets = e.getRegularTickets();
+        if (regularTickets.quantity < 0) {
+            if (!error.empty()) error += '\n';
+            error += "Regular tickets quantity must be greater than or equal to zero";
+            errC++;
+
+        }
+
+        if (regularTickets.quantity > 0 && regularTickets.price <= Money()) {
+            if (!error.empty()) error += '\n';
+            error += "Regular tickets price must be greater than zero";
+            errC++;
+        }
+
+        const auto& economicTickets = e.getEconomicTickets();
+        if (economicTickets.quantity < 0) {
+            if (!error.empty()) error += '\n';
+            error += " Economic tickets quantity must be greater than or equal to zero";
+            errC++;
+
+        }
+        if (economicTickets.quantity > 0 && economicTickets.price <= Money()) {
+            if (!error.empty()) error += '\n';
+            error += "Economic tickets price must be greater than zero";
+            errC++;
+        }
+
+        return errC;
+    }
+};
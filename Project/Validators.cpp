@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Allocation-free matchers for the ValidationService grammars
+// Each one accepts exactly the strings the matching std::regex accepted with regex_match,
+// but the pattern is compiled by hand into tables, so a call only walks the input once.
+namespace Validators {
+
+    // Standard form of Egyptian phone number: (010|011|012|015)[0-9]{8}
+    inline bool isEgyptianPhone(const char* s, size_t n) {
+        if (n != 11 || s[0] != '0' || s[1] != '1') return false;
+        if (s[2] != '0' && s[2] != '1' && s[2] != '2' && s[2] != '5') return false;
+        for (size_t i = 3; i < n; ++i) {
+            if (s[i] < '0' || s[i] > '9') return false;
+        }
+        return true;
+    }
+
+    // E-mail form following IETF standards:
+    //   [^@.]+(.[^@.]+)?(@[A-Za-z0-9]+)(\-[A-Za-z0-9]+)?(.[0-9]*[A-Za-z]+[0-9]*(\-[A-Za-z0-9]+)?)+
+    // (the unescaped '.' is kept as in the regex: any char but a line break)
+    // The pattern has 13 character positions, the set of positions the input can be at is
+    // kept in a bitmask and advanced per char (a Glushkov automaton), so no backtracking.
+    namespace email {
+        enum Class : uint8_t { NotAtDot, Any, At, Alnum, Dash, Digit, Alpha };
+
+        // position -> char class it consumes
+        constexpr Class positionClass[13] = {
+            NotAtDot,           // 0  [^@.]+
+            Any, NotAtDot,      // 1  . 2 [^@.]+
+            At, Alnum,          // 3  @ 4 [A-Za-z0-9]+
+            Dash, Alnum,        // 5  - 6 [A-Za-z0-9]+
+            Any, Digit, Alpha,  // 7  . 8 [0-9]* 9 [A-Za-z]+
+            Digit, Dash, Alnum  // 10 [0-9]* 11 - 12 [A-Za-z0-9]+
+        };
+
+        constexpr uint16_t bit(int p) { return (uint16_t)(1u << p); }
+
+        // position -> positions that may follow it
+        constexpr uint16_t follow[13] = {
+            bit(0) | bit(1) | bit(3),
+            bit(2),
+            bit(2) | bit(3),
+            bit(4),
+            bit(4) | bit(5) | bit(7),
+            bit(6),
+            bit(6) | bit(7),
+            bit(8) | bit(9),
+            bit(8) | bit(9),
+            bit(9) | bit(10) | bit(11) | bit(7),
+            bit(10) | bit(11) | bit(7),
+            bit(12),
+            bit(12) | bit(7)
+        };
+
+        constexpr uint16_t start = bit(0);
+        constexpr uint16_t accepting = bit(9) | bit(10) | bit(12);
+
+        inline bool inClass(Class c, unsigned char ch) {
+            bool digit = ch >= '0' && ch <= '9';
+            bool alpha = (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z');
+            switch (c) {
+                case NotAtDot: return ch != '@' && ch != '.';
+                case Any:      return ch != '\n' && ch != '\r';
+                case At:       return ch == '@';
+                case Alnum:    return digit || alpha;
+                case Dash:     return ch == '-';
+                case Digit:    return digit;
+                case Alpha:    return alpha;
+            }
+            return false;
+        }
+
+        // positions whose class accepts ch
+        inline uint16_t positionsFor(unsigned char ch) {
+            uint16_t mask = 0;
+            for (int p = 0; p < 13; ++p) {
+                if (inClass(positionClass[p], ch)) mask |= bit(p);
+            }
+            return mask;
+        }
+
+        // Built once: char -> positionsFor(char), and set of positions -> union of their follow sets,
+        // so one step of the automaton is two table lookups
+        struct Table {
+            uint16_t byChar[256];
+            uint16_t followOf[1 << 13];
+            Table() {
+                for (int c = 0; c < 256; ++c) byChar[c] = positionsFor((unsigned char)c);
+                followOf[0] = 0;
+                for (int m = 1; m < (1 << 13); ++m) {
+                    int lowest = 0;
+                    while (!(m & bit(lowest))) ++lowest;
+                    followOf[m] = followOf[m & (m - 1)] | follow[lowest];
+                }
+            }
+        };
+
+        inline const Table& table() {
+            static const Table t;
+            return t;
+        }
+    }
+
+    inline bool isEmail(const char* s, size_t n) {
+        const email::Table& t = email::table();
+        // positions that the next char may be at, the first char can only start the pattern
+        uint16_t next = email::start;
+        uint16_t current = 0;
+        for (size_t i = 0; i < n; ++i) {
+            current = next & t.byChar[(unsigned char)s[i]];
+            if (current == 0) return false;
+            next = t.followOf[current];
+        }
+        return (current & email::accepting) != 0;
+    }
+
+    inline bool isEmail(const string& s) { return isEmail(s.data(), s.size()); }
+    inline bool isEgyptianPhone(const string& s) { return isEgyptianPhone(s.data(), s.size()); }
+
+    // Batch forms: validate a whole column of inputs, results[i] is for inputs[i]
+    // Return the number of valid inputs
+    inline size_t areEmails(const vector<string>& inputs, vector<bool>& results) {
+        results.assign(inputs.size(), false);
+        size_t valid = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (isEmail(inputs[i])) {
+                results[i] = true;
+                ++valid;
+            }
+        }
+        return valid;
+    }
+
+    inline size_t areEgyptianPhones(const vector<string>& inputs, vector<bool>& results) {
+        results.assign(inputs.size(), false);
+        size_t valid = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (isEgyptianPhone(inputs[i])) {
+                results[i] = true;
+                ++valid;
+            }
+        }
+        return valid;
+    }
+}
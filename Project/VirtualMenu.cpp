@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+// Screen model behind displayMenu for lists of any length. Only the rows in the visible window
+// are drawn, and their text is asked for through itemText when drawn, so nothing is built per
+// entry up front. render() emits ANSI escape sequences for what changed since the last frame: the
+// whole screen once, the window's rows after a scroll, otherwise just the rows whose highlight
+// moved (and the position counter).
+//
+// Layout is displayMenu's: title on row 1, entries on every other row from row 3 at column 2, the
+// ESC hint escRow rows below the window and the description under the last entry.
+class VirtualMenu {
+public:
+    using ItemText = function<string(size_t index)>;
+
+    VirtualMenu(size_t nItems, ItemText itemText, string title, string descriptionTitle = "",
+                string description = "", int escRow = 3, int maxRows = 15)
+        : nItems(nItems), itemText(move(itemText)), title(move(title)),
+          descriptionTitle(move(descriptionTitle)), description(move(description)), escRow(escRow),
+          rows((size_t)min<size_t>(nItems, (size_t)max(maxRows, 1))) {}
+
+    size_t size() const { return nItems; }
+    size_t getSelected() const { return selected; }
+
+    // Up and down wrap around like the old menu
+    void up() { if (nItems) selected = (selected + nItems - 1) % nItems; }
+    void down() { if (nItems) selected = (selected + 1) % nItems; }
+    void home() { selected = 0; }
+    void end() { if (nItems) selected = nItems - 1; }
+    void pageUp() { selected = selected >= rows ? selected - rows : 0; }
+    void pageDown() { if (nItems) selected = min(nItems - 1, selected + rows); }
+
+    // Appends the escape sequences that bring the screen from the last frame to the current one
+    void render(string& out) {
+        if (selected < first) first = selected;
+        if (selected >= first + rows) first = selected - rows + 1;
+
+        if (!drawn) {
+            out += "\x1b[0m\x1b[H\x1b[2J";
+            moveTo(out, 0, 1);
+            out += title;
+            for (size_t i = first; i < first + rows; ++i) drawRow(out, i);
+            drawStatus(out);
+            if (!descriptionTitle.empty()) {
+                moveTo(out, 0, rows > 0 ? 2 + 2 * (int)rows : 2);
+                out += descriptionTitle + "\n";
+                if (!description.empty()) out += "\n" + description + "\n";
+            }
+        } else if (first != drawnFirst) {
+            for (size_t i = first; i < first + rows; ++i) drawRow(out, i);
+            drawStatus(out);
+        } else if (selected != drawnSelected) {
+            drawRow(out, drawnSelected);
+            drawRow(out, selected);
+            if (nItems > rows) drawStatus(out);
+        }
+        drawn = true;
+        drawnFirst = first;
+        drawnSelected = selected;
+    }
+
+private:
+    size_t nItems;
+    ItemText itemText;
+    string title;
+    string descriptionTitle;
+    string description;
+    int escRow;
+    size_t rows;
+
+    size_t selected = 0;
+    size_t first = 0;
+    bool drawn = false;
+    size_t drawnFirst = 0;
+    size_t drawnSelected = 0;
+
+    static void moveTo(string& out, int x, int y) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "\x1b[%d;%dH", y + 1, x + 1);
+        out += buf;
+    }
+
+    void drawRow(string& out, size_t index) {
+        moveTo(out, 0, 3 + 2 * (int)(index - first));
+        out += "\x1b[2K  ";
+        string text = itemText(index);
+        while (!text.empty() && text.back() == '\n') text.pop_back();
+        if (index == selected) {
+            out += "\x1b[7m" + text + "\x1b[0m";
+        } else {
+            out += text;
+        }
+    }
+
+    // ESC hint, with the position when the list is longer than the window
+    void drawStatus(string& out) {
+        moveTo(out, 0, 2 * (int)rows + escRow);
+        out += "\x1b[2KPress ESC to back.";
+        if (nItems > rows) out += "  " + to_string(selected + 1) + "/" + to_string(nItems);
+    }
+};
@@ -4,246 +4,25 @@
 #include <map>
 #include <algorithm>
 #include <cctype>
-#include <regex>
 #include <string>
+#include <chrono>
+#include <memory>
 
 #include "GenericMultiEditorForm.cpp"
+#include "EventForm.cpp"
 
 #include "EventManager.cpp"
 #include "FanManager.cpp"
 #include "AdminManager.cpp"
+#include "StorageManager.cpp"
+#include "BulkImporter.cpp"
+#include "ValidationService.cpp"
+#include "AuthenticationService.cpp"
+#include "PaymentService.cpp"
+#include "TicketakService.cpp"
 
 using namespace std;
 
-// ================= ENUMS =================
-enum class UserType {
-    Fan = 1,
-    Admin = 2,
-    NotAuth = 0
-};
-
-enum class EventFieldId {
-    Name,
-    Category,
-
-    DateDay,
-    DateMonth,
-    DateYear,
-
-    VipPrice,
-    VipQuantity,
-
-    RegularPrice,
-    RegularQuantity,
-
-    EconomicPrice,
-    EconomicQuantity
-};
-
-
-struct EventField : Field {
-    EventFieldId id;
-};
-
-
-// DTO for Login Data
-struct LoginDTO {
-    string email;
-    string password;
-};
-
-// ================= SERVICES =================
-class ValidationService {
-public:
-    static bool isValidEmail(const string &email) {
-        // A Form of E-mail following IETF standards
-        regex stdEmail("[^@.]+(.[^@.]+)?(@[A-Za-z0-9]+)(\\-[A-Za-z0-9]+)?(.[0-9]*[A-Za-z]+[0-9]*(\\-[A-Za-z0-9]+)?)+");
-        // If the user's email following the regex form return true, false otherwise
-        return regex_match(email, stdEmail);
-    }
-
-    static bool isValidNum(const string &phoneNum) {
-        // Standard form of Egyptian phone number
-        regex stdPhoneNum("(010|011|012|015)[0-9]{8}");
-        // If the user's phone number following the regex form return true, false otherwise
-        return regex_match(phoneNum, stdPhoneNum);
-    }
-
-    static bool isValidUserName(const string &userName) {
-        // User name should contain 4 to 20 characters
-        return (userName.size() <= 20 && userName.size() >= 3);
-    }
-
-    static bool isValidPassword(const string &password) {
-        return (password.size() >= 8);
-    }
-
-    static int isValidEvent(Event& e,string &error) {
-        int errC = 0;
-        if (e.getName().empty()) {
-            error = "Event name cannot be empty";
-            errC++;
-        }
-        
-        if (e.getDay() < 1 || e.getDay() > 31) {
-            if (!error.empty()) error += '\n';
-            error += "Invalid day";
-            errC++;
-        }
-        
-        if (e.getMonth() < 1 || e.getMonth() > 12) {
-            if (!error.empty()) error += '\n';
-            error += "Invalid month";
-            errC++;
-        }
-        
-        if (e.getYear() < 2025) {
-            if (!error.empty()) error += '\n';
-            error += "Invalid year";
-            errC++;
-        }
-
-        if (e.getEventStatus() == EventStatus::Finished) {
-            if (!error.empty()) error += '\n';
-            error += "Date Shouldn't be in the past";
-            errC++;
-        }
-
-        const auto& vipTickets = e.getVipTickets();
-        if (vipTickets.quantity < 0) {
-            if (!error.empty()) error += '\n';
-            error += "VIP tickets quantity must be greater than or equal to zero";
-            errC++;
-        }
-
-        if (vipTickets.quantity > 0 && vipTickets.price <= 0) {
-            if (!error.empty()) error += '\n';
-            error += "VIP tickets price must be greater than zero";
-            errC++;
-        }
-
-        const auto& regularTickets = e.getRegularTickets();
-        if (regularTickets.quantity < 0) {
-            if (!error.empty()) error += '\n';
-            error += "Regular tickets quantity must be greater than or equal to zero";
-            errC++;
-
-        }
-
-        if (regularTickets.quantity > 0 && regularTickets.price <= 0) {
-            if (!error.empty()) error += '\n';
-            error += "Regular tickets price must be greater than zero";
-            errC++;
-        }
-
-        const auto& economicTickets = e.getEconomicTickets();
-        if (economicTickets.quantity < 0) {
-            if (!error.empty()) error += '\n';
-            error += " Economic tickets quantity must be greater than or equal to zero";
-            errC++;
-
-        }
-        if (economicTickets.quantity > 0 && economicTickets.price <= 0) {
-            if (!error.empty()) error += '\n';
-            error += "Economic tickets price must be greater than zero";
-            errC++;
-        }
-
-        return errC;
-    }
-};
-
-class AuthenticationService {
-public:
-    // Logic uses FanManager and AdminManager to verify credentials
-    // Returns Pointer to the Fan/Admin or nullptr for wrong credentials
-    static User *login(const LoginDTO &user, UserType userType) {
-        if (userType == UserType::Fan) {
-            FanManager &fanManager = FanManager::getInstance();
-            return fanManager.getFanByEmailPass(user.email, user.password);
-        } else if (userType == UserType::Admin) {
-            AdminManager &adminManager = AdminManager::getInstance();
-            return adminManager.getAdminByEmailPass(user.email, user.password);
-        }
-        return nullptr;
-    }
-
-    // Only the Fan can register, Admin Added by developer
-    static bool _register(Fan &fan) {
-        FanManager &fanManager = FanManager::getInstance();
-
-        fan.setId(fanManager.getSize());
-        fanManager.addFan(fan);
-        return true;
-    }
-
-    static bool isExistingEmail(const string &email) {
-        FanManager &fanManager = FanManager::getInstance();
-        AdminManager &adminManager = AdminManager::getInstance();
-        return fanManager.getFanByEmail(email) != nullptr || adminManager.getAdminByEmail(email) != nullptr;
-    }
-};
-
-// ================= PAYMENT STRATEGY PATTERN =================
-
-// Abstract Interface
-class PaymentMethod {
-public:
-    virtual bool pay(double amount) = 0; // Pure virtual function
-    virtual ~PaymentMethod() = default;
-};
-
-class FawryPay : public PaymentMethod {
-public:
-    // Stateless payment logic
-    bool pay(double amount) override {
-        cout << "Paying " << amount << " via Fawry.\n";
-        return true;
-    }
-};
-
-class CreditCard : public PaymentMethod {
-private:
-    string name;
-    string cardNumber;
-    string cvv;
-    string expiryDate;
-
-public:
-    CreditCard(string n, string num, string c, string exp)
-            : name(n), cardNumber(num), cvv(c), expiryDate(exp) {}
-
-    void setName(const string &n) { name = n; }
-
-    void setCardNumber(const string &num) { cardNumber = num; }
-
-    void setCvv(const string &c) { cvv = c; }
-
-    void setExpiryDate(const string &exp) { expiryDate = exp; }
-
-    bool pay(double amount) override {
-        cout << "Paying " << amount << " via CreditCard " << cardNumber << ".\n";
-        return true;
-    }
-};
-
-class PaymentService {
-private:
-    PaymentMethod *paymentMethod; // Strategy pointer
-
-public:
-    void setPaymentMethod(PaymentMethod *method) {
-        this->paymentMethod = method;
-    }
-
-    bool processPayment(double amount) {
-        if (paymentMethod) {
-            return paymentMethod->pay(amount);
-        }
-        return false;
-    }
-};
-
 // ================= SYSTEM MANAGER (FACADE) =================
 
 class SystemManager {
@@ -254,7 +33,9 @@ private:
     Admin *currentAdmin = nullptr;
     Fan *currentFan = nullptr;
     UserType userType = UserType::NotAuth;
-    const string EMAIL_ALLOWED_CHARS = "A-Za-z0-9_@.%+-";
+    // Session of the logged in user in TicketakService, the console is one of its clients
+    string sessionToken;
+    static constexpr const char* EMAIL_ALLOWED_CHARS = "A-Za-z0-9_@.%+-";
 
     // Make current Admin Points at an Admin returned from Login Method (AdminManager.admins vector)
     void setCurrentAdmin(Admin &admin) {
@@ -273,6 +54,8 @@ private:
     // Note: SystemManager does not Own these Objects (FanManager & AdminManager Do)
     // so we don't delete them only points to them or points to null
     void logout() {
+        TicketakService::getInstance().logout(sessionToken);
+        sessionToken.clear();
         currentAdmin = nullptr;
         currentFan = nullptr;
         userType = UserType::NotAuth;
@@ -286,131 +69,6 @@ private:
         return userType == UserType::Fan;
     }
 
-    vector<EventField> &createEventFormFields() {
-        static vector<EventField> fields = {
-                {
-                        {
-                                "Event Name:",
-                                30,
-                                "A-Za-z ",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setName(v);
-                                }
-                        },
-                        EventFieldId::Name
-                },
-
-                // -------- DATE --------
-                {
-                        {
-                                "Day:",
-                                2,
-                                "0-9",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setDay(atoi(v));
-                                }
-                        },
-                        EventFieldId::DateDay
-                },
-                {
-                        {
-                                "Month:",
-                                2,
-                                "0-9",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setMonth(atoi(v));
-                                }
-                        },
-                        EventFieldId::DateMonth
-                },
-                {
-                        {
-                                "Year:",
-                                4,
-                                "0-9",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setYear(atoi(v));
-                                }
-                        },
-                        EventFieldId::DateYear
-                },
-
-                // -------- VIP TICKETS --------
-                {
-                        {
-                                "VIP Ticket Price:",
-                                7,
-                                "0-9.",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setTicketPrice(TicketType::VIP, atof(v));
-                                }
-                        },
-                        EventFieldId::VipPrice
-                },
-                {
-                        {
-                                "VIP Ticket Quantity:",
-                                6,
-                                "0-9",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setTicketQuantity(TicketType::VIP, atoi(v));
-                                }
-                        },
-                        EventFieldId::VipQuantity
-                },
-
-                // -------- REGULAR TICKETS --------
-                {
-                        {
-                                "Regular Ticket Price:",
-                                7,
-                                "0-9.",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setTicketPrice(TicketType::Regular, atof(v));
-                                }
-                        },
-                        EventFieldId::RegularPrice
-                },
-                {
-                        {
-                                "Regular Ticket Quantity:",
-                                6,
-                                "0-9",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setTicketQuantity(TicketType::Regular, atoi(v));
-                                }
-                        },
-                        EventFieldId::RegularQuantity
-                },
-
-                // -------- ECONOMIC TICKETS --------
-                {
-                        {
-                                "Economic Ticket Price:",
-                                7,
-                                "0-9.",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setTicketPrice(TicketType::Economic, atof(v));
-                                }
-                        },
-                        EventFieldId::EconomicPrice
-                },
-                {
-                        {
-                                "Economic Ticket Quantity:",
-                                6,
-                                "0-9",
-                                [](void *obj, const char *v) {
-                                    static_cast<Event *>(obj)->setTicketQuantity(TicketType::Economic, atoi(v));
-                                }
-                        },
-                        EventFieldId::EconomicQuantity
-                }
-        };
-
-        return fields;
-    }
-
     //function to display category menu and get user selection
     Category getCategoryFromUser(const string& prompt = "Choose Event Category") {
         vector<string> categories = {
@@ -432,54 +90,7 @@ private:
         return static_cast<Category>(choice);
     }
 
-    void fillEditEventData(vector<EventField> &fields, const Event &event) {
-        for (auto &f: fields) {
-            switch (f.id) {
-                case EventFieldId::Name:
-                    f.oldValue = event.getName();
-                    break;
-                case EventFieldId::DateDay:
-                    f.oldValue = to_string(event.getDay());
-                    break;
-
-                case EventFieldId::DateMonth:
-                    f.oldValue = to_string(event.getMonth());
-                    break;
-
-                case EventFieldId::DateYear:
-                    f.oldValue = to_string(event.getYear());
-                    break;
-
-                case EventFieldId::VipPrice:
-                    f.oldValue = event.getTicketPriceStr(TicketType::VIP);
-                    break;
-
-                case EventFieldId::VipQuantity:
-                    f.oldValue = event.getTicketQuantityStr(TicketType::VIP);
-                    break;
-
-                case EventFieldId::RegularPrice:
-                    f.oldValue = event.getTicketPriceStr(TicketType::Regular);
-                    break;
-
-                case EventFieldId::RegularQuantity:
-                    f.oldValue = event.getTicketQuantityStr(TicketType::Regular);
-                    break;
-
-                case EventFieldId::EconomicPrice:
-                    f.oldValue = event.getTicketPriceStr(TicketType::Economic);
-                    break;
-
-                case EventFieldId::EconomicQuantity:
-                    f.oldValue = event.getTicketQuantityStr(TicketType::Economic);
-                    break;
-            }
-        }
-    }
-
     bool viewCreateEventForm() {
-        vector<EventField> &eventFields = createEventFormFields();
-        vector<Field> fields(eventFields.begin(), eventFields.end());
         string error;
         int errC = 0;
         Event event;
@@ -491,52 +102,45 @@ private:
 
 
             while (true) {
-                if (!showForm(&event, fields, error, errC, 30))
+                // after a failed validation the form shows what was entered
+                if (!showForm(event, EVENT_FORM, error, errC, 30, errC > 0))
                     break;
 
                 error = "";
                 errC = ValidationService::isValidEvent(event, error);
                 if (!errC) {
                     event.setCategory(selectedCategory);
-                    EventManager::getInstance().addEvent(event);
-                    system("cls");
-                    cout << "Event #" << EventManager::getInstance().getNEvents() << " is created successfully";
-                    Sleep(1500);
+                    TicketakService::getInstance().createEvent(event);
+                    clearScreen();
+                    cout << "Event #" << event.getId() << " is created successfully";
+                    pauseMs(1500);
                     return true;
                 }
             }
         }
     }
 
-    Event *getEventIdFromUser() {
+    // Fills view with a copy of the event whose id the user enters, false on ESC
+    bool getEventFromUser(EventView& view) {
         bool isValidId = true;
         string errorMsg = "";
         int eventId = 0;
 
-        vector<Field> EventIdField = {
-                {
-                        "Event ID:", 10, "0-9",
-                        [](void *obj, const char *v) {
-                            *static_cast<int *>(obj) = atoi(v);
-                        }
-                }
-        };
+        static constexpr auto eventIdForm = makeForm<int>(valueField<int>("Event ID:", 10, "0-9"));
 
         do {
-            if (!showForm(&eventId, EventIdField, errorMsg, 0 , 15)) return nullptr;
+            if (!showForm(eventId, eventIdForm, errorMsg, 0 , 15)) return false;
             errorMsg = "";
-            Event *e = EventManager::getInstance().getEvent(eventId);
-            if (e != nullptr) return e;
+            if (TicketakService::getInstance().getEvent(eventId, view) == ServiceStatus::Ok) return true;
             else {
                 isValidId = false;
                 errorMsg = "Event ID is not found";
             }
         } while (!isValidId);
-        return nullptr;
+        return false;
     }
 
     bool viewEditEventForm(Event *event) {
-        vector<EventField> &eventFields = createEventFormFields();
         string error;
         int errC = 0;
 
@@ -544,64 +148,75 @@ private:
             Category currentCategory = event->getCategory();
 
             Category newCategory = getCategoryFromUser(
-                "Current: " + event->categoryToString(currentCategory) + "\nSelect new category or ESC to keep"
+                "Current: " + Event::categoryToString(currentCategory) + "\nSelect new category or ESC to keep"
             );
 
             if (newCategory == static_cast<Category>(-1)) return false;
 
             event->setCategory(newCategory);
 
-            fillEditEventData(eventFields, *event);
-            vector<Field> fields(eventFields.begin(), eventFields.end());
-
             while(true){
-                if (!showForm(event, fields, error, errC, 30))
+                // opened on the event's current values
+                if (!showForm(*event, EVENT_FORM, error, errC, 30, true))
                     break;
 
                 errC = ValidationService::isValidEvent(*event, error);
                 if (!errC) {
                     // set
-                    system("cls");
+                    clearScreen();
                     cout << "Event #" << event->getId() << " is edited successfully";
-                    Sleep(1500);
+                    pauseMs(1500);
                     return true;
                 }
             }
         }
     }
 
-    void getEventsMenu(vector<string>& eventsMenu, const vector<Event>& events){
-        for (const Event& e : events){
-            eventsMenu.push_back(e.viewDetailsBreifly());
+    // Menu of events, an entry's text is built only when it scrolls into view
+    // The views are copies taken by TicketakService, no Event is touched outside its lock
+    int displayEventsMenu(const vector<EventView>& events, const string& title){
+        return displayMenu(events.size(), [&events](size_t i) { return events[i].viewDetailsBreifly(); }, title);
+    }
+
+    // The event's details for the details pages, with its revenue for an admin
+    // false when the event was deleted since it was listed
+    bool getEventDetails(int eventId, string& details) {
+        Money revenue;
+        if (TicketakService::getInstance().getEventDetails(eventId, details, isAdmin() ? &revenue : nullptr) !=
+            ServiceStatus::Ok) {
+            displayMenu(vector<string>(), "Sorry, This Event is no longer available\n");
+            return false;
         }
+        if (isAdmin())
+            details += "\n  Revenue: " + revenue.toString() + " EGP";
+        return true;
     }
 
     // View Events Page to Fan to purchase
     int viewEventsForPurchase() {
-        EventManager &eventManager = EventManager::getInstance();
-        vector<string> eventsMenu;
-        const vector<Event>& events = eventManager.getEvents();
+        vector<EventView> events = TicketakService::getInstance().listEvents();
         int selectedTicketType = 0;
         int selectedEvent = 0;
 
-        // getEventsMenu
-        getEventsMenu(eventsMenu, events);
-
         while (true) {
-            selectedEvent = displayMenu(eventsMenu, "Current Events");
+            selectedEvent = displayEventsMenu(events, "Current Events");
 
             // if user clicks ESC
             if (selectedEvent == -1){
                 return -1;
             }
 
+            const EventView& event = events[selectedEvent - 1];
+            string details;
+            if (!getEventDetails(event.id, details)) continue;
+
             while (true) {
                 // when user chooses event, then make him choose ticket type of event and also show event details
                 selectedTicketType = displayMenu(
                     vector<string>{"1-VIP\n", "2-Economic\n", "3-Regular\n"},
                     "Choose your ticket type",
                     "Event details",
-                    events[selectedEvent - 1].viewDetails(),
+                    details,
                     17
                 );
 
@@ -610,7 +225,7 @@ private:
                     break;
                 }
 
-                if (events[selectedEvent-1].getEventStatus() == EventStatus::Finished) {
+                if (event.status == EventStatus::Finished) {
                     displayMenu(vector<string>(), "Sorry, This Event is already Finished\n");
                     continue;
                 }
@@ -620,19 +235,19 @@ private:
                 switch (selectedTicketType) {
                     case 1:
                         selectedTicketTypePrice.type = TicketType::VIP;
-                        selectedTicketTypePrice.price = events[selectedEvent-1].getVipTickets().price;
+                        selectedTicketTypePrice.price = event.vip.price;
                         break;
                     case 2:
                         selectedTicketTypePrice.type = TicketType::Economic;
-                        selectedTicketTypePrice.price = events[selectedEvent-1].getEconomicTickets().price;
+                        selectedTicketTypePrice.price = event.economic.price;
                         break;
                     case 3:
                         selectedTicketTypePrice.type = TicketType::Regular;
-                        selectedTicketTypePrice.price = events[selectedEvent-1].getRegularTickets().price;
+                        selectedTicketTypePrice.price = event.regular.price;
                         break;
                 }
                 
-                if (!purchasePage(events[selectedEvent-1].getId(), selectedTicketTypePrice)) {
+                if (!purchasePage(event.id, selectedTicketTypePrice)) {
                     continue;
                 }
                 return 0;
@@ -642,82 +257,74 @@ private:
     }
 
     bool purchasePage(int selectedEventId, TicketTypePrice selectedTicketTypePrice) {
-        PaymentService paymentService;
+        TicketakService &service = TicketakService::getInstance();
+        // chosen payment strategy, TicketakService runs it through a PaymentService
+        unique_ptr<PaymentMethod> paymentMethod;
+
+        // reserve the ticket before payment, so nobody can buy it while the fan pays
+        uint64_t holdId;
+        ServiceStatus status = service.reserveTicket(sessionToken, selectedEventId, selectedTicketTypePrice.type, holdId);
+        if (status != ServiceStatus::Ok) {
+            displayMenu(vector<string>(), status == ServiceStatus::SoldOut
+                ? "Unavailable tickets please try again later."
+                : TicketakService::statusToString(status) + ".");
+            return false;
+        }
+        long holdMinutes = (long)chrono::duration_cast<chrono::minutes>(service.getReservationTtl()).count();
 
         while (true) {
             int selectedPaymentMethod = displayMenu(
                     vector<string>{"1-Fawry Pay\n", "2-Credit Card\n"},
                     "Choose your payment method",
-                    "Ticket price ", "  " + to_string(selectedTicketTypePrice.price), 7
+                    "Ticket price ", "  " + selectedTicketTypePrice.price.toString() + " EGP" +
+                        "\n  Your ticket is reserved for " + to_string(holdMinutes) + " minutes", 8
             );
 
-            system("cls");
+            clearScreen();
             // handle ESC case
             if (selectedPaymentMethod == -1){
+                service.cancelReservation(sessionToken, holdId);
                 return false;
             }
             // User select to pay with Fawry
             else if (selectedPaymentMethod == 1) {
-                PaymentMethod *fawry = new FawryPay();
-                paymentService.setPaymentMethod(fawry);
+                paymentMethod.reset(new FawryPay());
                 break;
             }
             // User select to pay with Credit Card
             else if (selectedPaymentMethod == 2) {
-                vector<Field> creditCardFields = {
-                        {
-                                "Cardholder Name:",   30, "A-Za-z ",
-                                [](void *cc, const char *input) {
-                                    ((CreditCard *) cc)->setName(input);
-                                }
-                        },
-                        {
-                                "Card Number:",       16, "0-9",
-                                [](void *cc, const char *input) {
-                                    ((CreditCard *) cc)->setCardNumber(input);
-                                }
-                        },
-                        {
-                                "CVV:",               4,  "0-9",
-                                [](void *cc, const char *input) {
-                                    ((CreditCard *) cc)->setCvv(input);
-                                }
-                        },
-                        {
-                                "Exp Date(MM-YYYY):", 7,  "0-9-",
-                                [](void *cc, const char *input) {
-                                    ((CreditCard *) cc)->setExpiryDate(input);
-                                }
-                        }
-                };
-                PaymentMethod *creditCard = new CreditCard("", "", "", "");
-                if (!showForm(creditCard, creditCardFields , "" , 0, 21)) {
+                static constexpr auto creditCardForm = makeForm<CreditCard>(
+                        field("Cardholder Name:",   30, "A-Za-z ", &CreditCard::setName),
+                        field("Card Number:",       16, "0-9",     &CreditCard::setCardNumber),
+                        field("CVV:",               4,  "0-9",     &CreditCard::setCvv),
+                        field("Exp Date(MM-YYYY):", 7,  "0-9-",    &CreditCard::setExpiryDate)
+                );
+                unique_ptr<CreditCard> creditCard(new CreditCard("", "", "", ""));
+                if (!showForm(*creditCard, creditCardForm , "" , 0, 21)) {
                     cout << "Credit card entry canceled!\n";
                     continue;
                 }
-                system("cls");
-                paymentService.setPaymentMethod(creditCard);
+                clearScreen();
+                paymentMethod = move(creditCard);
                 break;
             }
         }
 
-        // pay for ticket
-        paymentService.processPayment(selectedTicketTypePrice.price);
-
-        // after pay for ticket we will book ticket for that event
-        EventManager &eventManager = EventManager::getInstance();
-        Event *event = eventManager.getEvent(selectedEventId);
-        Ticket createdTicket = event->bookEvent(currentFan->getId(), selectedTicketTypePrice);
+        // pay for the reserved ticket and book it, the created ticket is added to current fan tickets
+        // keyed by the reservation, so the purchase is never charged twice for it
+        Ticket createdTicket;
+        status = service.confirmReservation(sessionToken, holdId, *paymentMethod, createdTicket,
+                                            "console-" + to_string(holdId));
         // case booking is failed
-        if (createdTicket.getId() == "0") {
-            displayMenu(vector<string>(), "Unavailable tickets please try again later.");
+        if (status != ServiceStatus::Ok) {
+            displayMenu(vector<string>(), status == ServiceStatus::SoldOut
+                ? "Unavailable tickets please try again later."
+                : TicketakService::statusToString(status) + ".");
             return false;
         }
-        // Add created ticket to current fan tickets
-        currentFan->buyTicket(createdTicket);
-        system("cls");
+        clearScreen();
         cout << "Payment is Completed Successfully, Backing to Main Menu in 1 Sec.";
-        Sleep(1200);
+        pauseMs(1200);
         return true;
     }
 
@@ -747,23 +354,27 @@ private:
                     viewCreateEventForm();
                     break;
                 case 2: {
-                    Event *e = getEventIdFromUser();
-                    if (e == nullptr) break;
-                    viewEditEventForm(e);
+                    EventView view;
+                    if (!getEventFromUser(view)) break;
+                    // the form edits a copy, the service saves it once it is valid
+                    TicketakService &service = TicketakService::getInstance();
+                    Event edited(view.id, view.name, view.category, view.date, view.vip, view.economic, view.regular);
+                    if (viewEditEventForm(&edited))
+                        service.editEvent(edited);
                     break;
                 }
                 case 3: {
-                    Event *e = getEventIdFromUser();
-                    if (e == nullptr) break;
-                    int eventID = e->getId();
-                    if (EventManager::getInstance().deleteEvent(eventID)){
-                        system("cls");
+                    EventView view;
+                    if (!getEventFromUser(view)) break;
+                    int eventID = view.id;
+                    if (TicketakService::getInstance().deleteEvent(eventID) == ServiceStatus::Ok){
+                        clearScreen();
                         cout << "Event #"<< eventID << " is deleted successfully";
-                        Sleep(1500);
+                        pauseMs(1500);
                     }
                 }
                 case 4:{
-                    viewEvents(EventManager::getInstance().getEvents(),"====== All Events ======");
+                    viewEvents(TicketakService::getInstance().listEvents(), "====== All Events ======");
                     break;
                 }
                 case 5:
@@ -779,18 +390,40 @@ private:
 
     int viewMyTicketsPage() {
         if (!currentFan) return -1;
+        TicketakService &service = TicketakService::getInstance();
+        Fan *fan = currentFan;
 
-        vector<string> ticketOptions = currentFan->buildTicketsMenuItems();
-
-        if (ticketOptions.size() == 1 && currentFan->getMyTickets().empty()) {
-            displayMenu(ticketOptions, "====== My Tickets ======");
+        // the fan's tickets (and their events) are read under the service's lock, a page is copied out as text
+        if (!service.withManagers([fan] { return fan->hasTickets(); })) {
+            displayMenu(service.withManagers([fan] { return fan->buildTicketsMenuItems(0, 0); }),
+                        "====== My Tickets ======");
             return 0;
         }
 
+        // one page of tickets at a time, a fan with thousands renders as fast as one with a few
+        const size_t pageSize = 50;
+        size_t from = 0;
         while (true) {
+            size_t total;
+            vector<string> ticketOptions = service.withManagers([fan, from, pageSize, &total] {
+                total = fan->getTicketCount();
+                return fan->buildTicketsMenuItems(from, pageSize);
+            });
+            int pageItems = (int)ticketOptions.size();
+            int nextChoice = -1, previousChoice = -1;
+            if (from + pageSize < total) {
+                ticketOptions.push_back(to_string(ticketOptions.size() + 1) + "- Next page\n");
+                nextChoice = (int)ticketOptions.size();
+            }
+            if (from > 0) {
+                ticketOptions.push_back(to_string(ticketOptions.size() + 1) + "- Previous page\n");
+                previousChoice = (int)ticketOptions.size();
+            }
+
             int choice = displayMenu(
                     ticketOptions,
-                    "====== My Tickets ======",
+                    "====== My Tickets (" + to_string(from + 1) + "-" + to_string(from + pageItems) + " of " +
+                        to_string(total) + ") ======",
                     "Select a ticket to view details",
                     "",
                     5
@@ -799,8 +432,17 @@ private:
             if (choice == -1) {
                 return 0;
             }
+            if (choice == nextChoice) {
+                from += pageSize;
+                continue;
+            }
+            if (choice == previousChoice) {
+                from -= pageSize;
+                continue;
+            }
 
-            string ticketDetails = currentFan->getTicketDetails(choice - 1);
+            int index = (int)from + choice - 1;
+            string ticketDetails = service.withManagers([fan, index] { return fan->getTicketDetails(index); });
 
             if (displayMenu(vector<string>(), "", ticketDetails, "", 12) == -1){
                 continue;
@@ -819,21 +461,14 @@ private:
 
         while (true) {
             int choice = displayMenu(searchOptions, "======= Search For Event =======");
-            vector<Event> matchedEvents;
+            vector<EventView> matchedEvents;
             bool exit = false;
             switch(choice){
                 case 1: {
                     string name;
-                    vector<Field> nameField {{
-                        "Event Name:",
-                        30,
-                        "A-Za-z ",
-                        [](void* obj, const char* v) {
-                            *static_cast<string*>(obj) = v;
-                        }
-                    }};
-                    if (!showForm(&name, nameField)) {exit = true; break;}
-                    matchedEvents = searchEventsByName(name);
+                    static constexpr auto nameForm = makeForm<string>(valueField<string>("Event Name:", 30, "A-Za-z "));
+                    if (!showForm(name, nameForm)) {exit = true; break;}
+                    matchedEvents = TicketakService::getInstance().searchByName(name);
                     break;
                 }
                 case 2: {
@@ -847,13 +482,14 @@ private:
                         break;
                     }
 
-                    matchedEvents = searchEventsByCategory(selectedCategory);
+                    // in date order
+                    matchedEvents = TicketakService::getInstance().searchByCategory(selectedCategory);
                     break;
                 }
                 case 3: {
-                    Event* event = getEventIdFromUser();
-                    if (event == nullptr) {exit = true; break;}
-                    matchedEvents.push_back(*event);
+                    EventView event;
+                    if (!getEventFromUser(event)) {exit = true; break;}
+                    matchedEvents.push_back(event);
                     break;
                 }
                 case -1:
@@ -864,9 +500,9 @@ private:
 
             //Check if no events found
             if (matchedEvents.empty()) {
-            system("cls");
+            clearScreen();
             cout << "No events found matching your search criteria.\n";
-            Sleep(2000);
+            pauseMs(2000);
             continue;
         }
 
@@ -875,23 +511,19 @@ private:
     }
 
     // View Passed Events
-    void viewEvents(const vector<Event>& events,const string& menuMsg){
+    void viewEvents(const vector<EventView>& events,const string& menuMsg){
         if (!events.empty()) {
-            vector<string> eventsMenu;
-            getEventsMenu(eventsMenu, events);
-
             while (true) {
-                int selectedEventIndex = displayMenu(eventsMenu, menuMsg);
+                int selectedEventIndex = displayEventsMenu(events, menuMsg);
 
                 // Back to Search Menu
                 if (selectedEventIndex == -1){
                     break;
                 }
 
-                displayMenu(vector<string>(), "====== Event Details ======",
-                    events[selectedEventIndex - 1].viewDetails(),
-                    "", 16
-                );
+                string details;
+                if (!getEventDetails(events[selectedEventIndex - 1].id, details)) continue;
+                displayMenu(vector<string>(), "====== Event Details ======", details, "", 16);
             }
         }
     }
@@ -933,45 +565,20 @@ private:
     }
 
     bool viewRegisterForm() {
-        vector<Field> registerFormFields = {
-                {
-                        "Name:",        20, "A-Za-z ",
-                        [](void *user, const char *nameInput) {
-                            ((Fan *) user)->setName(nameInput);
-                        }
-                },
-                {
-                        "Email:",       50, EMAIL_ALLOWED_CHARS,
-                        [](void *user, const char *emailInput) {
-                            ((Fan *) user)->setEmail(emailInput);
-                        }
-                },
-                {
-                        "Password:",    50, " -~",
-                        [](void *user, const char *pass) {
-                            ((Fan *) user)->setPassword(pass);
-                        }
-                },
-                {
-                        "Gender(M|F):", 1,  "MFmf",
-                        [](void *user, const char *gender) {
-                            ((Fan *) user)->setGender(toupper(gender[0]));
-                        }
-                },
-                {
-                        "Phone:",       11, "0-9",
-                        [](void *user, const char *phone) {
-                            ((Fan *) user)->setPhoneNumber(phone);
-                        }
-                }
-        };
+        static constexpr auto registerForm = makeForm<Fan>(
+                field("Name:",        20, "A-Za-z ",           &Fan::setName,        &Fan::getName),
+                field("Email:",       50, EMAIL_ALLOWED_CHARS, &Fan::setEmail,       &Fan::getEmail),
+                field("Password:",    50, " -~",               &Fan::setPassword,    &Fan::getPassword),
+                field("Gender(M|F):", 1,  "MFmf",              &Fan::setGender,      &Fan::getGender),
+                field("Phone:",       11, "0-9",               &Fan::setPhoneNumber, &Fan::getPhoneNumber)
+        );
 
         Fan fan;
         string errorMsg = "";
         bool cancelForm = false;
         int errorCount = 0;
         do {
-            if (!showForm(&fan, registerFormFields, errorMsg, errorCount, 21))
+            if (!showForm(fan, registerForm, errorMsg, errorCount, 21, errorCount > 0))
                 cancelForm = true;
 
             // reset the errors
@@ -983,7 +590,7 @@ private:
                 ++errorCount;
             }
 
-            if (AuthenticationService::isExistingEmail(fan.getEmail())) {
+            if (TicketakService::getInstance().isEmailInUse(fan.getEmail())) {
                 errorMsg += "\nEmail is already in use.";
                 ++errorCount;
             }
@@ -999,32 +606,26 @@ private:
             }
 
             if (!errorCount) {
-                if (AuthenticationService::_register(fan)) {
-                    system("cls");
+                string message;
+                if (TicketakService::getInstance().registerFan(fan, message) == ServiceStatus::Ok) {
+                    clearScreen();
                     cout << "Registration is done successfully, Forwarding to Login Page in 2 sec\n";
-                    Sleep(2000);
+                    pauseMs(2000);
                     return true;
                 }
+                // taken by another registration since the check above
+                errorMsg = "\n" + message;
+                errorCount = 1;
             }
         } while (!cancelForm);
         return false;
     }
 
     int viewLoginForm() {
-        vector<Field> loginFormFields = {
-            {
-                "Email:",    50, EMAIL_ALLOWED_CHARS,
-                [](void *user, const char *emailInput) {
-                    ((LoginDTO *) user)->email = emailInput;
-                }
-            },
-            {
-                        "Password:", 50, " -~",
-                        [](void *user, const char *pass) {
-                            ((LoginDTO *) user)->password = pass;
-                        }
-                }
-        };
+        static constexpr auto loginForm = makeForm<LoginDTO>(
+            field("Email:",    50, EMAIL_ALLOWED_CHARS, &LoginDTO::email),
+            field("Password:", 50, " -~",               &LoginDTO::password)
+        );
 
         bool abortLoginFormFill = false;
         do {
@@ -1038,7 +639,7 @@ private:
             string errorMsg = "";
             do {
                 LoginDTO user;
-                if (!showForm(&user, loginFormFields, errorMsg, 0, 15)) {
+                if (!showForm(user, loginForm, errorMsg, 0, 15)) {
                     // if user press on ESC to return to Choosing User Type Menu
                     abortLoginFormFill = true;
                     break;
@@ -1046,7 +647,9 @@ private:
 
                 UserType userType = static_cast<UserType>(user_type);
 
-                currentUser = AuthenticationService::login(user, userType);
+                TicketakService &service = TicketakService::getInstance();
+                if (service.login(user, userType, sessionToken) == ServiceStatus::Ok)
+                    currentUser = service.getUser(sessionToken);
                 if (currentUser != nullptr) {
                     if (userType == UserType::Fan) {
                         Fan *fan = static_cast<Fan *>(currentUser);
@@ -1066,37 +669,6 @@ private:
 
         return -1;
     }
-
-    vector<Event> searchEventsByCategory(Category category) {
-        EventManager &eventManager = EventManager::getInstance();
-        vector<Event> allEvents = eventManager.getEvents();
-        vector<Event> matchedEvents;
-        for (const Event &event: allEvents) {
-            if (event.getCategory() == category) {
-                matchedEvents.push_back(event);
-            }
-        }
-        return matchedEvents;
-    }
-
-    vector<Event> searchEventsByName(const string& name) {
-        const vector<Event>& allEvents = EventManager::getInstance().getEvents();
-        vector<Event> matchedEvents;
-
-        // helper function to lowercase a string
-        auto toLower = [](string s) {
-            transform(s.begin(), s.end(), s.begin(), ::tolower);
-            return s;
-        };
-
-        for (const Event &event: allEvents) {
-            // if Event Name Contains the input name (case insensitive) then push it into matchedEvents
-            if (toLower(event.getName()).find(toLower(name)) != string::npos) {
-                matchedEvents.push_back(event);
-            }
-        }
-        return matchedEvents;
-    }
 };
 
 
@@ -1134,7 +706,7 @@ void SystemManager::run() {
                 break;
             }
             case -1: {
-                system("cls");
+                clearScreen();
                 cout << "Thanks for using Ticketak :)\n";
                 return;
             }
@@ -1145,30 +717,94 @@ void SystemManager::run() {
 
 // ================= MAIN (ENTRY POINT) =================
 
-int main() {
+// Bulk load of fans or events ("--import-fans"/"--import-events"), .jsonl files are read as JSONL, others as CSV
+int runImport(const string& what, const string& path) {
+    ImportFormat format = path.size() >= 6 && path.compare(path.size() - 6, 6, ".jsonl") == 0
+        ? ImportFormat::Jsonl : ImportFormat::Csv;
+    BulkImporter importer;
+    ImportStats stats;
+    bool ok;
+
+    if (what == "--import-fans") {
+        ok = importer.importFans(path, format, [](const Fan& fan, string& error) {
+            if (!ValidationService::isValidEmail(fan.getEmail())) error = "Email is not valid.";
+            else if (AdminManager::getInstance().getAdminByEmail(fan.getEmail()) != nullptr) error = "Email is already in use.";
+            else if (!ValidationService::isValidUserName(fan.getName())) error = "The Name Should be from 4 to 20 characters.";
+            else if (!ValidationService::isValidPassword(fan.getPassword())) error = "The Password Should be at least 8 characters.";
+            else if (!ValidationService::isValidNum(fan.getPhoneNumber())) error = "Phone number is not valid.";
+            return error.empty();
+        }, stats);
+    } else {
+        ok = importer.importEvents(path, format, [](Event& event, string& error) {
+            return ValidationService::isValidEvent(event, error) == 0;
+        }, stats);
+    }
+
+    if (!ok) {
+        cout << "Could not read " << path << "\n";
+        return 1;
+    }
+
+    for (const string& error : stats.errors) cout << error << "\n";
+    cout << stats.imported << " imported, " << stats.invalid << " invalid, " << stats.duplicates << " duplicates of "
+         << stats.records << " records in " << stats.seconds << " s (" << (long long)stats.recordsPerSec() << " records/sec)\n";
+
+    // one snapshot for the whole import instead of a log record per row
+    return StorageManager::getInstance().checkpoint() ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    EventManager& eventManager = EventManager::getInstance();
+
+    // Published events are served from the memory-mapped catalog, if there is one
+    const string catalogPath = "data/events.catalog";
+    eventManager.attachCatalog(catalogPath);
+
+    // Restore the managers from the last snapshot + write-ahead log (on top of the catalog)
+    StorageManager& storage = StorageManager::getInstance();
+    if (!storage.open("data")) {
+        cout << "Warning: stored data could not be fully loaded\n";
+        pauseMs(1500);
+    }
+
     //Admin admin("Karim", "admin@ticketak.com", "password", 'M', "01065243880");
     Admin admin("Karim", "a", "p", 'M', "01065243880");
-    AdminManager::getInstance().addAdmin(admin);
+    if (AdminManager::getInstance().getAdminByEmail(admin.getEmail()) == nullptr)
+        AdminManager::getInstance().addAdmin(admin);
 
     Fan fan("Ahmad", "f", "p", 'M', "01065246880");
-    FanManager::getInstance().addFan(fan);
+    if (FanManager::getInstance().getFanByEmail(fan.getEmail()) == nullptr) {
+        FanManager::getInstance().addFan(fan);
+        storage.logAddFan(fan);
+    }
 
-    EventManager& eventManager = EventManager::getInstance();
+    // "--export-catalog" publishes all current events as a new catalog file,
+    // it replaces data/events.catalog while the application is not running
+    if (argc > 1 && string(argv[1]) == "--export-catalog") {
+        vector<Event*> events = eventManager.getEvents();
+        bool exported = EventCatalog::write(catalogPath + ".new",
+            vector<const Event*>(events.begin(), events.end()));
+        cout << (exported ? "Catalog written to " + catalogPath + ".new\n" : "Catalog export failed\n");
+        return exported ? 0 : 1;
+    }
 
-    if (eventManager.getEvents().empty()) {
-        TicketTypePriceQuantity vip1{TicketType::VIP, 500.0, 50};
-        TicketTypePriceQuantity eco1{TicketType::Economic, 200.0, 150};
-        TicketTypePriceQuantity reg1{TicketType::Regular, 100.0, 300};
+    if (argc > 2 && (string(argv[1]) == "--import-fans" || string(argv[1]) == "--import-events"))
+        return runImport(argv[1], argv[2]);
+
+    if (eventManager.getNEvents() == 0) {
+        TicketTypePriceQuantity vip1{TicketType::VIP, Money::pounds(500), 50};
+        TicketTypePriceQuantity eco1{TicketType::Economic, Money::pounds(200), 150};
+        TicketTypePriceQuantity reg1{TicketType::Regular, Money::pounds(100), 300};
         Date date1{10, 1, 2026};
 
-        TicketTypePriceQuantity vip2{TicketType::VIP, 1000.0, 30};
-        TicketTypePriceQuantity eco2{TicketType::Economic, 400.0, 70};
-        TicketTypePriceQuantity reg2{TicketType::Regular, 150.0, 200};
+        TicketTypePriceQuantity vip2{TicketType::VIP, Money::pounds(1000), 30};
+        TicketTypePriceQuantity eco2{TicketType::Economic, Money::pounds(400), 70};
+        TicketTypePriceQuantity reg2{TicketType::Regular, Money::pounds(150), 200};
         Date date2{15, 6, 2026};
 
-        TicketTypePriceQuantity vip3{TicketType::VIP, 800.0, 40};
-        TicketTypePriceQuantity eco3{TicketType::Economic, 300.0, 120};
-        TicketTypePriceQuantity reg3{TicketType::Regular, 120.0, 250};
+        TicketTypePriceQuantity vip3{TicketType::VIP, Money::pounds(800), 40};
+        TicketTypePriceQuantity eco3{TicketType::Economic, Money::pounds(300), 120};
+        TicketTypePriceQuantity reg3{TicketType::Regular, Money::pounds(120), 250};
         Date date3{20, 12, 2025};
 
         Event event1(1, "Rock Concert", Category::Parties, date1, vip1, eco1, reg1);
@@ -1178,9 +814,16 @@ int main() {
         eventManager.addEvent(event1);
         eventManager.addEvent(event2);
         eventManager.addEvent(event3);
+        storage.logAddEvent(event1);
+        storage.logAddEvent(event2);
+        storage.logAddEvent(event3);
     }
 
     SystemManager app;
     app.run();
+
+    // Fold the log into a fresh snapshot so the next start only loads the snapshot
+    TicketakService::getInstance().checkpoint();
+    storage.close();
     return 0;
 }